@@ -5,7 +5,7 @@
 //    Description: Renders a textured sphere using either Immediate Mode calls,
 //                 Immediate Mode calls cached in a Display List, or as a 
 //                 collection of geometric data stored in an interleaved 
-//                 fashion within a Vertex Array.
+//                 fashion within a Vertex Array or a Vertex Buffer Object.
 //
 //   Control Keys: Left Mouse Button - Spin the view.
 //                 F1 - Decrease sphere precision.
@@ -15,24 +15,147 @@
 //                 F5 - Use a Vertex Array
 //                 F6 - Perform Benchmarking
 //                 F7 - Toggle wire-frame mode.
+//                 F8 - Use a Vertex Buffer Object
+//                 F9 - Cycle through the strip, indexed, cache-optimized and
+//                      icosphere vertex layouts.
+//                 F10 - Cycle through the float, half and short vertex 
+//                       formats used by the Vertex Array and VBO modes.
+//                 F11 - Stream the sphere through a ring of buffer objects,
+//                       a few bands at a time.
+//                 F12 - Toggle rebuilding the sphere in the background when 
+//                       the precision changes.
+//                 P - Generate the sphere in a vertex shader, from nothing 
+//                     but the vertex index.
+//                 I - Ray-cast the sphere in a fragment shader, on a single 
+//                     quad whatever the precision.
+//                 T - Transform the sphere on the CPU with SIMD, across the
+//                     generation threads, and draw it pre-transformed.
+//                 L - Toggle adjusting the precision to hold the frame time 
+//                     budget.
+//                 C - Toggle culling the back-facing parts of the bands in
+//                     the Vertex Array and VBO modes.
+//                 B - Toggle drawing the bands of the strip layout as
+//                     separate strips in the Vertex Array and VBO modes.
+//                 M - Toggle minifying the texture from its mipmaps.
+//
+//   Command Line: --headless         - Render into an EGL p-buffer with no 
+//                                      window or X server, run a single 
+//                                      benchmark and print it as JSON.
+//                 --mode <name>      - immediate, display_list, vertex_array,
+//                                      vertex_buffer, streaming, procedural,
+//                                      impostor, software_tnl
+//                 --layout <name>    - strip, indexed, optimized, icosphere.
+//                                      The icosphere subdivides the
+//                                      icosahedron until no edge is longer
+//                                      than the longest of the UV sphere at
+//                                      the same precision, and is timed
+//                                      against the UV sphere of equal
+//                                      geometric error.
+//                 --cache-size <n>   - Vertices in the simulated FIFO 
+//                                      post-transform cache.
+//                 --format <name>    - float, half, short
+//                 --kernel <name>    - scalar, sse, avx. Vertex generation 
+//                                      kernel, the best supported one by 
+//                                      default.
+//                 --threads <n>      - Threads generating the sphere, one
+//                                      per processor by default.
+//                 --generation-scaling - Also time generating the sphere
+//                                      on 1 up to that many threads.
+//                 --mesh-cache-mb <n>- Memory budget for the spheres kept 
+//                                      around for other precisions and 
+//                                      layouts. 0 disables the cache.
+//                 --mesh-dir <dir>   - Where spheres that were slow to 
+//                                      generate are saved, and mapped back
+//                                      from the next time they're needed.
+//                                      Without it there are no files, and
+//                                      nothing is written to disk.
+//                 --precision <n>    - Sphere precision.
+//                 --frames <n>       - Number of frames to benchmark.
+//                 --warmup <n>       - Frames rendered before timing starts.
+//                 --width <n>        - Width of the window or p-buffer.
+//                 --height <n>       - Height of the window or p-buffer.
+//                 --sweep <p,p,...>  - Benchmark every render mode at each 
+//                                      of these precisions, headless, and 
+//                                      print the results as a JSON array.
+//                 --csv <file>       - Also write the sweep to a CSV file.
+//                 --baseline <file>  - Compare the sweep against a CSV file 
+//                                      written by --csv, and exit with 2 if
+//                                      any median frame time regressed.
+//                 --threshold <pct>  - Regression allowed before failing, 
+//                                      10 percent by default.
+//                 --spheres <n>      - Draw a grid of n spheres, each with 
+//                                      its own transform and texture offset.
+//                 --instanced        - Draw all the spheres with a single 
+//                                      instanced call. Only the vertex_array
+//                                      and vertex_buffer modes support it.
+//                 --target-ms <ms>   - Adjust the precision as the frames go 
+//                                      by to hold this frame time. Can't be 
+//                                      used with --sweep.
+//                 --cull             - Skip the back-facing parts of the
+//                                      bands, in the vertex_array and
+//                                      vertex_buffer modes with the strip
+//                                      layout.
+//                 --band-strips      - Draw each band of the strip layout as
+//                                      a strip of its own, without the
+//                                      triangles joining one band to the
+//                                      next, and time both ways.
+//                 --scaling <n>      - Render the sphere from 1, 2, ... n 
+//                                      threads at once, each with a context
+//                                      and p-buffer of its own, and report
+//                                      the aggregate frame rate and every 
+//                                      thread's frame times. The contexts 
+//                                      are GLX ones on one shared X 
+//                                      connection, or EGL ones with 
+//                                      --headless. Only the immediate, 
+//                                      display_list, vertex_array and 
+//                                      vertex_buffer modes.
+//                 --texture-size <n> - Stretch mars.bmp to n x n texels, say
+//                                      8192 or 16384, to upload and sample
+//                                      a texture that size.
+//                 --direct-upload    - Upload the texture in one call from
+//                                      client memory, instead of a strip
+//                                      of rows at a time through pixel 
+//                                      buffers.
+//                 --no-mipmaps       - Minify the texture from its base 
+//                                      level alone.
+//                 --compare-mipmaps  - Time the frames again with the other
+//                                      minification filter, to see what 
+//                                      the mipmaps save.
 //-----------------------------------------------------------------------------
 
 #include <X11/X.h>
 #include <X11/Xutil.h>
 #include <X11/keysym.h>
 #include <math.h>
-#include <sys/timeb.h>
+#include <time.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 
+// Buffer objects are core since OpenGL 1.5, and libGL exports them directly
+#define GL_GLEXT_PROTOTYPES
 #include <GL/glx.h>
 #include <GL/gl.h>
 #include <GL/glu.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "vertex_cache.h"
+#include "sphere_kernels.h"
+#include "thread_pool.h"
+#include "mesh_file.h"
+#include "vertex_transform.h"
+#include "geometry.h"
 
 //-----------------------------------------------------------------------------
 // DEFINES
@@ -40,6 +163,92 @@ using namespace std;
 #define IMMEDIATE_MODE 0
 #define DISPLAY_LIST   1
 #define VERTEX_ARRAY   2
+#define VERTEX_BUFFER  3
+#define STREAMING_MODE 4
+#define PROCEDURAL     5
+#define IMPOSTOR_MODE  6
+#define SOFTWARE_TNL   7
+
+#define NUM_RENDER_MODES 8
+
+#define STRIP_LAYOUT     0
+#define INDEXED_LAYOUT   1
+#define OPTIMIZED_LAYOUT 2
+#define ICOSPHERE_LAYOUT 3
+
+#define NUM_LAYOUTS 4
+
+#define FLOAT_FORMAT 0
+#define HALF_FORMAT  1
+#define SHORT_FORMAT 2
+
+#define NUM_VERTEX_FORMATS 3
+
+#define MAX_GENERATION_THREADS 64
+
+// The software transform hands the threads this many vertices at a time
+#define TRANSFORM_BLOCK_VERTICES 2048
+
+// The texture is uploaded this many bytes of rows at a time, through this
+// many pixel unpack buffers taking turns
+#define TEXTURE_STRIP_BYTES        (4 * 1024 * 1024)
+#define NUM_TEXTURE_UPLOAD_BUFFERS 2
+
+// The streaming mode regenerates the sphere every frame into this many 
+// buffer objects of about this size, so its memory use doesn't grow with 
+// the precision.
+#define NUM_STREAM_BUFFERS 3
+#define STREAM_CHUNK_BYTES (4 * 1024 * 1024)
+
+// Spheres of other precisions and layouts are kept in the mesh cache, up to
+// this many of them and a memory budget.
+#define MAX_CACHED_MESHES 32
+#define DEFAULT_MESH_CACHE_MB 512
+
+// Spheres that generate faster than this, in milliseconds, aren't worth a 
+// mesh file
+#define MESH_FILE_MIN_BUILD_MS 50.0f
+
+#define MAX_SWEEP_PRECISIONS 64
+#define MAX_CSV_COLUMNS      64
+
+#define MAX_SPHERES 100000
+
+// Precisions the sphere can be asked for, from the command line or with F2
+#define MIN_PRECISION 4
+#define MAX_PRECISION 30000
+
+#define MAX_SCALING_THREADS 64
+
+// Where render() puts the sphere, and the field of view it's seen with
+#define VIEW_DISTANCE 5.0f
+#define FIELD_OF_VIEW 45.0f
+
+// The adaptive LOD controller looks at the median of this many frames, and
+// only moves the precision when it's outside the band around the budget. 
+// It never goes finer than an edge of LOD_PIXELS_PER_EDGE pixels along the
+// sphere's silhouette, since the extra triangles couldn't be seen.
+#define LOD_WINDOW_FRAMES     15
+#define LOD_RAISE_BELOW       0.8f
+#define LOD_LOWER_ABOVE       1.1f
+#define LOD_PIXELS_PER_EDGE   2.0f
+#define MIN_LOD_PRECISION     8
+#define MAX_LOD_PRECISION     30000
+#define DEFAULT_LOD_TARGET_MS 16.6f
+
+// Band culling splits every band into this many pieces around the sphere,
+// each with the cone that bounds its normals
+#define CULL_SEGMENTS 16
+
+// GPU timer queries in flight. Each is read back this many frames after it
+// was issued, by which time the GPU is long done with it.
+#define TIMER_QUERY_FRAMES 4
+
+// Generic attribute slots used by the instancing shader
+#define POSITION_ATTRIB        0
+#define TEXCOORD_ATTRIB        1
+#define INSTANCE_ATTRIB        2
+#define INSTANCE_OFFSET_ATTRIB 3
 
 //-----------------------------------------------------------------------------
 // GLOBALS
@@ -49,19 +258,103 @@ Window     g_window;
 GLXContext g_glxContext;
 bool       g_bDoubleBuffered = GL_TRUE;
 
+// Headless rendering goes to an EGL p-buffer instead of an X window
+bool       g_bHeadless   = false;
+EGLDisplay g_eglDisplay  = EGL_NO_DISPLAY;
+EGLSurface g_eglSurface  = EGL_NO_SURFACE;
+EGLContext g_eglContext  = EGL_NO_CONTEXT;
+EGLConfig  g_eglConfig;
+
+// Submission scaling. Without a window, the main context renders to 
+// g_glxPbuffer, and every thread's context shares the sphere, display list
+// and texture with it.
+int        g_nScalingThreads = 0;
+GLXPbuffer g_glxPbuffer      = 0;
+
+// One of the threads of the scaling benchmark, with the context and 
+// p-buffer it made, GLX or EGL, and the times of the frames it rendered
+struct ScalingWorker
+{
+    pthread_t  thread;
+    GLXPbuffer pbuffer;
+    GLXContext context;
+    EGLSurface eglSurface;
+    EGLContext eglContext;
+    bool       bReady;
+    float     *pFrameTimes;
+    uint64_t   nStart;
+    uint64_t   nEnd;
+};
+
+// All the threads of one run of the scaling benchmark. The frame rate is 
+// every frame rendered over the time from the first thread starting to the
+// last one finishing, and the frame times are in milliseconds.
+struct ScalingResult
+{
+    int    nNumThreads;
+    int    nNumFailed;
+    float  fElapsed;
+    float  fFramesPerSecond;
+    float  afMedianFrameTime[MAX_SCALING_THREADS];
+    float  afP95FrameTime[MAX_SCALING_THREADS];
+    float  afP99FrameTime[MAX_SCALING_THREADS];
+    float  afMaxFrameTime[MAX_SCALING_THREADS];
+};
+
+// Lines the threads up once their contexts are made, and again before the
+// timed frames
+pthread_barrier_t g_scalingBarrier;
+
+int g_nWindowWidth     = 640;
+int g_nWindowHeight    = 480;
+int g_nBenchmarkFrames = 1000;
+int g_nWarmUpFrames    = 10;
+
+// Precisions benchmarked by --sweep, and what to do with the results
+GLuint      g_anSweepPrecisions[MAX_SWEEP_PRECISIONS];
+int         g_nNumSweepPrecisions = 0;
+const char *g_pSweepCSVFile       = NULL;
+const char *g_pBaselineFile       = NULL;
+float       g_fRegressionPercent  = 10.0f;
+
 float g_fSpinX           = 0.0f;
 float g_fSpinY           = 0.0f;
 int   g_nLastMousePositX = 0;
 int   g_nLastMousePositY = 0;
 bool  g_bMousing         = false;
 
-GLuint g_sphereDList;
+GLuint g_sphereDList = 0;
+GLuint g_sphereVBO = 0;
+GLuint g_sphereIBO = 0;
 GLuint g_textureID = 0;
 
+// The sphere texture's size, 0 for the bitmap's own, how it was uploaded, 
+// and how long that and building its mipmaps took, in milliseconds
+int    g_nTextureSize         = 0;
+bool   g_bDirectTextureUpload = false;
+bool   g_bMipmaps             = true;
+bool   g_bCompareMipmaps      = false;
+GLuint g_nTextureWidth        = 0;
+GLuint g_nTextureHeight       = 0;
+int    g_nTextureStrips       = 0;
+float  g_fTextureUploadTime   = 0.0f;
+float  g_fMipmapTime          = 0.0f;
+
+// The process's resident set size either side of the last rebuild that 
+// switched render mode, and the mode it switched from. Nothing has been
+// built before the first, so it switches from NUM_RENDER_MODES.
+GLuint g_nRebuildMode      = NUM_RENDER_MODES;
+GLuint g_nSwitchedFromMode = NUM_RENDER_MODES;
+size_t g_nRSSBeforeSwitch  = 0;
+size_t g_nRSSAfterSwitch   = 0;
+
 bool    g_bRenderInWireFrame = false;
 GLuint  g_nCurrentMode = IMMEDIATE_MODE;
+GLuint  g_nSphereLayout = STRIP_LAYOUT;
+GLuint  g_nVertexFormat = FLOAT_FORMAT;
 GLuint  g_nPrecision  = 100;
 GLuint  g_nNumSphereVertices;
+float   g_fSphereRadius = 1.5f;
 GLfloat g_fMarsSpin   = 0.0f;
 
 // A custom data structure for our interleaved vertex attributes
@@ -75,6 +368,345 @@ struct Vertex
 
 Vertex *g_pSphereVertices = NULL; // Points to Vertex Array
 
+// Compact copies of g_pSphereVertices for the Vertex Array and VBO modes. 
+// Normals are normalized signed bytes, padded to 4 bytes, in both. Mesa's 
+// glNormalPointer() rejects GL_INT_2_10_10_10_REV, which would be the same 
+// size with two more bits of precision.
+//
+// HALF_FORMAT:  half-float texture coordinates, float positions (20 bytes)
+// SHORT_FORMAT: short texture coordinates scaled by the texture matrix, and 
+//               short positions scaled by the modelview matrix to fit the 
+//               sphere's radius (16 bytes)
+struct HalfVertex
+{
+    GLhalf tu, tv;
+    GLbyte nx, ny, nz, pad;
+    float  vx, vy, vz;
+};
+
+struct ShortVertex
+{
+    GLshort tu, tv;
+    GLbyte  nx, ny, nz, pad;
+    GLshort vx, vy, vz, pad2;
+};
+
+GLvoid *g_pPackedVertices      = NULL;
+GLuint  g_nPackedFormat        = FLOAT_FORMAT;
+float   g_fPackedPositionScale = 1.0f;
+
+// Format the sphere's buffer object was last filled with
+GLuint  g_nBufferFormat        = FLOAT_FORMAT;
+
+// Only used by the indexed layouts. The indices are 16 bit whenever the 
+// vertex count allows it, and 32 bit otherwise.
+GLvoid *g_pSphereIndices       = NULL;
+GLenum  g_sphereIndexType      = GL_UNSIGNED_SHORT;
+GLenum  g_sphereIndexPrimitive = GL_TRIANGLE_STRIP;
+GLuint  g_nNumSphereIndices    = 0;
+
+// Simulated post-transform cache behaviour of the current sphere
+int   g_nVertexCacheSize = 32;
+float g_fSphereACMR      = 0.0f;
+float g_fSphereATVR      = 0.0f;
+
+// Kernel used to generate the vertices, and how long the last rebuild took
+int   g_nSphereKernel    = getBestSphereKernel();
+float g_fSphereBuildTime = 0.0f;
+
+// The bands of the sphere are split across this many threads. 0 means one 
+// per processor.
+int   g_nGenerationThreads = 0;
+
+// Whether a benchmark also times the generation on 1, 2, ... threads,
+// which takes three full generations per thread count
+bool  g_bGenerationScaling = false;
+
+// Streaming mode state. Only the sin/cos tables are kept between frames.
+GLuint       g_streamVBOs[NUM_STREAM_BUFFERS] = { 0 };
+SphereTables g_streamTables      = { 0, 0, NULL, NULL, NULL };
+int          g_nStreamChunkBands = 0;
+int          g_nStreamChunks     = 0;
+
+// Procedural mode state. The shader works every vertex out from 
+// gl_VertexID, so there's no vertex data anywhere.
+GLuint g_proceduralProgram       = 0;
+GLint  g_nProceduralPrecisionLoc = -1;
+GLint  g_nProceduralRadiusLoc    = -1;
+GLuint g_nProceduralPrecision    = 0;
+
+// Impostor mode state. Every sphere is a single quad, ray-cast per pixel.
+GLuint g_impostorProgram      = 0;
+GLint  g_nImpostorRadiusLoc   = -1;
+
+// The stress scene. Every sphere is scaled and moved to its cell of a grid,
+// and its texture is shifted by tu so they don't all look the same.
+struct SphereInstance
+{
+    float x, y, z, scale;
+    float tu;
+};
+
+int             g_nNumSpheres        = 1;
+bool            g_bInstancedScene    = false;
+SphereInstance *g_pSphereInstances   = NULL;
+GLuint          g_instanceVBO        = 0;
+GLuint          g_instanceProgram    = 0;
+GLint           g_nPositionScaleLoc  = -1;
+
+// Adaptive LOD. While it's on, the precision follows the frame time.
+bool   g_bAdaptiveLOD   = false;
+float  g_fLODTargetTime = DEFAULT_LOD_TARGET_MS;
+float  g_afLODFrameTimes[LOD_WINDOW_FRAMES];
+int    g_nLODFrames     = 0;
+int    g_nLODChanges    = 0;
+
+// Band culling. The cones are made for g_nCullPrecision, one per piece of
+// a band, and render() fills the first/count arrays with the visible runs.
+struct CullCone
+{
+    float ax, ay, az;   // Axis
+    float fCos, fSin;   // Of the half-angle
+};
+
+bool      g_bBandCulling       = false;
+CullCone *g_pCullCones         = NULL;
+GLint    *g_pCullFirsts        = NULL;
+GLsizei  *g_pCullCounts        = NULL;
+GLuint    g_nCullPrecision     = 0;
+int       g_nCullSegmentCols   = 0;
+uint64_t  g_nCulledVertices    = 0;
+uint64_t  g_nSubmittedVertices = 0;
+
+// Per-band strips. The strip layout's array is drawn as one strip per band
+// with g_pBandFirsts and g_pBandCounts, made for g_nBandStripPrecision.
+bool      g_bBandStrips          = false;
+GLint    *g_pBandFirsts          = NULL;
+GLsizei  *g_pBandCounts          = NULL;
+GLuint    g_nBandStripPrecision  = 0;
+
+// GPU timer queries. Every frame's drawing is wrapped in a GL_TIME_ELAPSED
+// query from a ring of TIMER_QUERY_FRAMES. While g_pGPUFrameTimes is set,
+// the results are collected there as they're read back.
+bool      g_bTimerQueries                          = false;
+GLuint    g_timerQueries[TIMER_QUERY_FRAMES]       = { 0 };
+bool      g_bTimerQueryPending[TIMER_QUERY_FRAMES] = { false };
+int       g_nTimerQuery                            = 0;
+float    *g_pGPUFrameTimes                         = NULL;
+int       g_nNumGPUFrameTimes                      = 0;
+int       g_nMaxGPUFrameTimes                      = 0;
+int       g_nLateTimerQueries                      = 0;
+
+// CPU time of the last render(), in milliseconds, split between issuing
+// the GL calls and presenting the frame
+float     g_fSubmitTime = 0.0f;
+float     g_fSwapTime   = 0.0f;
+
+// Software T&L. Each sphere is transformed on the CPU into 
+// g_pTransformedVertices, which has room for g_nMaxTransformedVertices, 
+// and drawn with identity matrices. g_fTransformTime is the CPU time the 
+// last frame spent transforming, in milliseconds.
+GLfloat  *g_pTransformedVertices    = NULL;
+GLuint    g_nMaxTransformedVertices = 0;
+float     g_fTransformTime          = 0.0f;
+
+// Everything the sphere of one precision, radius and layout is drawn from. 
+// The current sphere lives in the globals above, and rebuildSphere() swaps 
+// it in and out of the mesh cache as the settings change. Representations 
+// that haven't been needed yet are left NULL or 0.
+struct SphereMesh
+{
+    GLuint   nPrecision;
+    float    fRadius;
+    GLuint   nLayout;
+
+    Vertex  *pVertices;
+    GLuint   nNumVertices;
+    GLvoid  *pPackedVertices;
+    GLuint   nPackedFormat;
+    float    fPackedPositionScale;
+    GLvoid  *pIndices;
+    GLenum   indexType;
+    GLenum   indexPrimitive;
+    GLuint   nNumIndices;
+    float    fACMR;
+    float    fATVR;
+
+    // The mesh file pVertices and pIndices point into, if they were mapped 
+    // rather than generated
+    void    *pMeshFile;
+    size_t   nMeshFileBytes;
+
+    GLuint   dList;
+    GLuint   vbo;
+    GLuint   ibo;
+    GLuint   nBufferFormat;
+
+    uint64_t nLastUsed;
+};
+
+// The key of the current sphere. A precision of 0 means there isn't one.
+GLuint     g_nMeshPrecision = 0;
+float      g_fMeshRadius    = 0.0f;
+GLuint     g_nMeshLayout    = STRIP_LAYOUT;
+
+SphereMesh g_meshCache[MAX_CACHED_MESHES];
+int        g_nNumCachedMeshes  = 0;
+size_t     g_nMeshCacheBudget  = (size_t)DEFAULT_MESH_CACHE_MB * 1024 * 1024;
+uint64_t   g_nMeshCacheClock   = 0;
+int        g_nMeshCacheHits    = 0;
+int        g_nMeshCacheMisses  = 0;
+
+// Mesh files, only with --mesh-dir. The current sphere's arrays are mapped
+// from g_pMeshFile, if they weren't generated. The counts are bumped from 
+// the builder thread too.
+const char *g_pMeshFileDir      = "";
+void       *g_pMeshFile         = NULL;
+size_t      g_nMeshFileBytes    = 0;
+int         g_nMeshFilesLoaded  = 0;
+int         g_nMeshFilesWritten = 0;
+
+// Time from main() to the first sphere being ready, in milliseconds
+uint64_t    g_nStartTime   = 0;
+float       g_fStartupTime = 0.0f;
+
+// Background rebuilds. The builder thread fills the client arrays of 
+// g_builderMesh while render() keeps drawing the current sphere, and the 
+// main loop swaps it in between two frames once it's done.
+bool       g_bBackgroundRebuild = true;
+bool       g_bBuilderRunning    = false;
+int        g_nBuilderDone       = 0;
+pthread_t  g_builderThread;
+SphereMesh g_builderMesh;
+GLuint     g_nBuilderFormat     = FLOAT_FORMAT;
+float      g_fBuilderTime       = 0.0f;
+
+struct BenchmarkResult
+{
+    GLuint nMode;
+    GLuint nPrecision;
+    GLuint nLayout;
+    GLuint nVertexFormat;
+    GLuint nBytesPerVertex;
+    GLuint nNumVertices;
+    GLuint nNumIndices;
+    size_t nVertexBytes;
+    size_t nIndexBytes;
+    GLuint nNumTriangles;
+    int    nCacheSize;
+    float  fACMR;
+    float  fATVR;
+    int    nSphereKernel;
+    float  fBuildTime;
+
+    // Meshes kept for other precisions and layouts, not counting this one
+    int    nNumCachedMeshes;
+    size_t nMeshCacheBytes;
+    size_t nMeshCacheBudget;
+    int    nMeshCacheHits;
+    int    nMeshCacheMisses;
+
+    // Time to the first frame, and the mesh files mapped and saved so far
+    float  fStartupTime;
+    int    nMeshFilesLoaded;
+    int    nMeshFilesWritten;
+
+    // Time to generate the vertices on 1, 2, ... threads, in milliseconds
+    int    nNumGenerationThreads;
+    float  afGenerationTime[MAX_GENERATION_THREADS];
+
+    int    nFrames;
+    int    nWarmUpFrames;
+    float  fElapsed;
+    float  fFramesPerSecond;
+    float  fTrianglesPerSecond;
+
+    // Spheres in the scene, and how many times per frame they were submitted
+    int    nNumSpheres;
+    bool   bInstanced;
+    int    nDrawsPerFrame;
+
+    // Frame time the adaptive LOD aimed for, 0 if it was off, and how many 
+    // times it changed the precision so far
+    float  fLODTargetTime;
+    int    nLODChanges;
+
+    // Fraction of the sphere's vertices band culling skipped, over the 
+    // timed frames
+    bool   bBandCulling;
+    float  fCulledFraction;
+
+    // With per-band strips, the joining triangles left out of each sphere
+    // and the median frame time of the same frames drawn as one strip
+    bool   bBandStrips;
+    GLuint nStitchTriangles;
+    float  fSingleStripMedian;
+
+    // Longest edge and furthest any triangle strays inside the sphere. For
+    // the icosphere, its edge frequency and the cache-optimized UV sphere
+    // with no more error, along with that sphere's median frame time.
+    float  fMaxEdge;
+    float  fMaxError;
+    int    nIcosphereFrequency;
+    GLuint nEqualErrorPrecision;
+    GLuint nEqualErrorVertices;
+    float  fEqualErrorMedian;
+
+    // Medians of the CPU time spent issuing each frame's GL calls and then
+    // presenting it, and of the GPU time from the timer queries, nGPUFrames
+    // of which came back. Queries still in flight when their slot came round
+    // again were dropped rather than waited on.
+    float  fSubmitMedian;
+    float  fSwapMedian;
+    float  fGPUMedian;
+    int    nGPUFrames;
+    int    nLateTimerQueries;
+
+    // With software T&L, the median time spent transforming and on how many
+    // threads, and the median frame time of the same sphere drawn from a 
+    // float vertex array and transformed by the driver
+    float  fTransformMedian;
+    int    nTransformThreads;
+    float  fDriverTransformMedian;
+
+    // The texture's size, the strips it was uploaded in and how long that
+    // and its mipmaps took, and the median frame time minified from the 
+    // mipmaps and from the base level alone. Only the one g_bMipmaps picked
+    // is timed without --compare-mipmaps, and the other is left at 0.
+    GLuint nTextureWidth;
+    GLuint nTextureHeight;
+    int    nTextureStrips;
+    bool   bDirectTextureUpload;
+    bool   bMipmaps;
+    float  fTextureUploadTime;
+    float  fMipmapTime;
+    float  fMipmappedMedian;
+    float  fBaseLevelMedian;
+
+    // Bytes the current sphere holds on to as client arrays, display list,
+    // buffer objects and texture with its mipmaps, and how many of them the
+    // current mode draws from, texture aside. Then the resident set size 
+    // either side of switching to this mode, and now.
+    size_t nClientArrayBytes;
+    size_t nDisplayListBytes;
+    size_t nBufferObjectBytes;
+    size_t nTextureBytes;
+    size_t nModeBytes;
+    GLuint nSwitchedFromMode;
+    size_t nRSSBeforeSwitch;
+    size_t nRSSAfterSwitch;
+    size_t nResidentBytes;
+
+    // Per-frame latency, in milliseconds
+    float  fMinFrameTime;
+    float  fMedianFrameTime;
+    float  fP95FrameTime;
+    float  fP99FrameTime;
+    float  fMaxFrameTime;
+    float  fMeanFrameTime;
+    float  fStdDevFrameTime;
+};
+
 struct BMPImage
 {
     int   width;
@@ -87,16 +719,147 @@ struct BMPImage
 //-----------------------------------------------------------------------------
 int main(int argc, char **argv);
 void render(void);
+void drawSphere(void);
+void drawSphereScene(void);
+void drawSphereInstances(void);
+bool canDrawInstanced(void);
+void createSphereInstances(void);
+void updateLODController(float fFrameTime);
+float getSphereScreenRadius(void);
+GLuint getLODPrecisionCap(void);
+void createCullCones(void);
+void destroyCullCones(void);
+bool canCullBands(void);
+void drawVisibleBands(void);
+void getSphereEye(float *pEye);
+void createBandStrips(void);
+void destroyBandStrips(void);
+bool canDrawBandStrips(void);
+void drawBandStrips(void);
+float timeMedianFrame(int nFrames);
+void createFrameTimers(void);
+void destroyFrameTimers(void);
+void beginFrameTimer(void);
+void endFrameTimer(void);
+void readFrameTimer(int nQuery);
+void finishFrameTimers(void);
+GLuint createShaderProgram(const char *pVertexSource, const char *pFragmentSource,
+                           const char **ppAttribNames, int nNumAttribs);
+GLuint compileShader(GLenum type, const char *pSource);
 void init(void);
 void shutDown(void);
 void getBitmapImageData(char *pFileName, BMPImage *pImage);
 void loadTexture(void);
+int uploadTextureStrips(const GLubyte *pData, int nWidth, int nHeight);
+void setTextureFilter(void);
+void resampleTexture(BMPImage *pImage, int nSize);
+void resampleTextureRows(void *pData, int nFirst, int nLast);
 void renderSphere(float cx, float cy, float cz, float r, int n);
 void createSphereDisplayList();
+void createSphereBuffer();
 void createSphereGeometry( float cx, float cy, float cz, float r, int n);
-void setVertData(int index,float tu, float tv, float nx, float ny, float nz, 
-                 float vx, float vy, float vz);
+void setSphereArrays(const SphereMesh *pMesh);
+void loadSphereMesh(SphereMesh *pMesh, float cx, float cy, float cz, float r, int p,
+                    GLuint nLayout);
+void getMeshFileName(char *pFileName, size_t nSize, float r, int p, GLuint nLayout);
+bool mapSphereMesh(SphereMesh *pMesh, const char *pFileName, float r, int p, GLuint nLayout);
+bool saveSphereMesh(const SphereMesh *pMesh, const char *pFileName, float r, int p,
+                    GLuint nLayout);
+void generateSphereMesh(SphereMesh *pMesh, float cx, float cy, float cz, float r, int p,
+                        GLuint nLayout);
+void generateIcosphereMesh(SphereMesh *pMesh, float cx, float cy, float cz, float r, int p);
+GLuint getIcosphereIndex(const int anEdges[30][2], const int anFaceEdges[20][3], int n,
+                         int f, int i, int j);
+int getIcosphereFrequency(int p, float r);
+float getIcosphereError(int n, float r, float *pfMaxEdge);
+float getUVSphereError(int p, float r, float *pfMaxEdge);
+int getEqualErrorPrecision(float fMaxError, float r);
+double getTriangleError(const double *a, const double *b, const double *c, double r, double *pdMaxEdge);
+void generateIndexedSphereMesh(SphereMesh *pMesh, float cx, float cy, float cz, float r, int p,
+                               GLuint nLayout);
+void generateSphereVertices(Vertex *pVertices, float cx, float cy, float cz, float r, int p,
+                            GLuint nLayout, int nNumThreads);
+void generateStripBands(void *pData, int nFirst, int nLast);
+void generateIndexedRings(void *pData, int nFirst, int nLast);
+void generateSphereBands(Vertex *pVertices, const SphereTables *pTables, int p,
+                         int nFirstBand, int nNumBands, int nNumThreads);
+void createSphereStream(void);
+void renderSphereStream(void);
+void createSphereProcedural(void);
+void renderSphereProcedural(void);
+void createSphereImpostor(void);
+void renderSphereImpostor(void);
+void createSphereSoftware(void);
+void renderSphereSoftware(void);
+void transformSphereBlocks(void *pData, int nFirst, int nLast);
+bool hasSphereMesh(GLuint nMode);
+GLuint getNumLayoutVertices(GLuint nLayout, int p);
+void measureGenerationScaling(BenchmarkResult *pResult);
+void setIndexData(SphereMesh *pMesh, int index, GLuint value);
+GLuint getIndexData(int index);
+GLuint getIndexSize(void);
+void packSphereVertices(void);
+void packSphereMesh(SphereMesh *pMesh, GLuint nFormat);
+GLhalf floatToHalf(float f);
+GLbyte packSnorm8(float f);
+GLuint getVertexFormatSize(GLuint nFormat);
+const GLvoid *getSphereVertexData(void);
+void beginSphereArrays(const GLubyte *pBase);
+void endSphereArrays(void);
 void doBenchmark(void);
+void runBenchmark(BenchmarkResult *pResult);
+uint64_t getTimeNanoseconds(void);
+float getPercentile(const float *pSorted, int nCount, float fPercent);
+void printBenchmarkReport(const BenchmarkResult *pResult);
+void printBenchmarkJSON(const BenchmarkResult *pResult);
+void rebuildSphere(void);
+void getMemoryFootprint(BenchmarkResult *pResult);
+size_t getBufferObjectBytes(GLuint buffer);
+size_t getTextureBytes(void);
+size_t getResidentBytes(void);
+void completeSphereMesh(void);
+GLuint getSphereMeshLayout(GLuint nMode);
+void rebuildSphereInBackground(void);
+void startSphereBuilder(void);
+void *sphereBuilderMain(void *pArg);
+void updateSphereBuilder(bool bWait);
+bool isSphereMeshCached(GLuint nPrecision, float fRadius, GLuint nLayout);
+void selectSphereMesh(GLuint nPrecision, float fRadius, GLuint nLayout);
+void detachSphereMesh(SphereMesh *pMesh);
+void attachSphereMesh(const SphereMesh *pMesh);
+void freeSphereMesh(SphereMesh *pMesh);
+size_t getSphereMeshBytes(const SphereMesh *pMesh);
+void cacheSphereMesh(const SphereMesh *pMesh);
+void evictOldestMesh(void);
+bool findCachedMesh(GLuint nPrecision, float fRadius, GLuint nLayout, SphereMesh *pMesh);
+size_t getMeshCacheBytes(void);
+void clearMeshCache(void);
+const char *getRenderModeName(GLuint nMode);
+const char *getRenderModeKey(GLuint nMode);
+const char *getLayoutName(GLuint nLayout);
+const char *getLayoutKey(GLuint nLayout);
+const char *getVertexFormatName(GLuint nFormat);
+const char *getVertexFormatKey(GLuint nFormat);
+bool parseCommandLine(int argc, char **argv);
+void printUsage(const char *pProgramName);
+bool initHeadlessContext(void);
+int runHeadlessBenchmark(void);
+int runSweepBenchmark(void);
+int runScalingBenchmark(void);
+bool initPbufferContext(void);
+bool createPbufferContext(GLXContext shareContext, GLXPbuffer *pPbuffer, GLXContext *pContext);
+void *scalingWorkerMain(void *pArg);
+bool makeScalingContext(ScalingWorker *pWorker);
+void destroyScalingContext(ScalingWorker *pWorker);
+void renderScalingFrame(void);
+void runScalingThreads(int nNumThreads, ScalingResult *pResult);
+void printScalingReport(const ScalingResult *pResults, int nNumResults);
+void printScalingJSON(const ScalingResult *pResults, int nNumResults);
+bool parsePrecisionList(const char *pList);
+bool writeBenchmarkCSV(const char *pFileName, const BenchmarkResult *pResults, int nNumResults);
+int compareWithBaseline(const char *pFileName, const BenchmarkResult *pResults, int nNumResults);
+int splitCSVLine(char *pLine, char **ppFields, int nMaxFields);
+int findCSVColumn(char **ppHeader, int nNumColumns, const char *pName);
 
 //-----------------------------------------------------------------------------
 // Name: main()
@@ -104,6 +867,24 @@ void doBenchmark(void);
 //-----------------------------------------------------------------------------
 int main( int argc, char **argv )
 {
+    g_nStartTime = getTimeNanoseconds();
+
+    if( !parseCommandLine( argc, argv ) )
+    {
+        printUsage( argv[0] );
+        exit(1);
+    }
+
+    // The scaling benchmark renders from threads of its own, into 
+    // p-buffers, so it needs no window either way
+    if( g_nScalingThreads > 0 )
+        return runScalingBenchmark();
+
+    // Without a display there is nothing to interact with, so just run one
+    // benchmark off-screen and report it.
+    if( g_bHeadless )
+        return runHeadlessBenchmark();
+
     // Open a connection to the X server
     g_pDisplay = XOpenDisplay( NULL );
 
@@ -180,7 +961,7 @@ int main( int argc, char **argv )
 
     // Create an X window with the selected visual
     g_window = XCreateWindow( g_pDisplay, RootWindow(g_pDisplay, visualInfo->screen), 
-                              0, 0, 640, 480, 0, visualInfo->depth, InputOutput, 
+                              0, 0, g_nWindowWidth, g_nWindowHeight, 0, visualInfo->depth, InputOutput, 
 						      visualInfo->visual, CWBorderPixel | CWColormap | CWEventMask,
                               &winAttr );
 
@@ -197,8 +978,9 @@ int main( int argc, char **argv )
     // they occur.
     //
 
-    XEvent event;
-	bool bRunning = true;
+    XEvent   event;
+	bool     bRunning        = true;
+    uint64_t nLastFrameStart = 0;
 	
     while( bRunning )
     {
@@ -220,53 +1002,110 @@ int main( int argc, char **argv )
 		                    if( g_nPrecision > 5 )
 		                        g_nPrecision -= 2;
 
-		                    if( g_nCurrentMode == DISPLAY_LIST )
-		                        createSphereDisplayList();
-
-  	                  		if( g_nCurrentMode == VERTEX_ARRAY ||
-   		                        g_nCurrentMode == IMMEDIATE_MODE)
-   		                 	{
-   		                     	createSphereGeometry( 0.0f, 0.0f, 0.0f, 1.5f, g_nPrecision );
-   		                 	}
-
- 		  		         	cout << "Sphere Resolution = " << g_nPrecision << endl;
-   		                 	break;
-
- 		  		        case XK_F2:
-	   		                 if( g_nPrecision < 30000 )
-	   		                     g_nPrecision += 2;
-	
-	 		  		         if( g_nCurrentMode == DISPLAY_LIST )
-	   		                 {
-	   		                     createSphereDisplayList();
-	   		                 }
-	
-	 		  		         if( g_nCurrentMode == VERTEX_ARRAY ||
-	   		                     g_nCurrentMode == IMMEDIATE_MODE )
-	   		                 {
-	   		                     createSphereGeometry( 0.0f, 0.0f, 0.0f, 1.5f, g_nPrecision );
-	   		                 }
-	
-	 		  		         cout << "Sphere Resolution = " << g_nPrecision << endl;
-	   		                 break;
-
-	  		             case XK_F3:
-	   		                 g_nCurrentMode = IMMEDIATE_MODE;
-	   		                 cout << "Render Method: Immediate Mode" << endl;
-	   		                 createSphereGeometry( 0.0f, 0.0f, 0.0f, 1.5f, g_nPrecision );
-	   		                 break;
-
-	  		             case XK_F4:
-	   		                 g_nCurrentMode = DISPLAY_LIST;
-	   		                 createSphereDisplayList();
-	   		                 cout << "Render Method: Display List" << endl;
-	   		                 break;
-
-	  		             case XK_F5:
-	   		                 g_nCurrentMode = VERTEX_ARRAY;
-	   		                 createSphereGeometry( 0.0f, 0.0f, 0.0f, 1.5f, g_nPrecision );
-	   		                 cout << "Render Method: Vertex Array" << endl;
-	   		                 break;
+		                    rebuildSphereInBackground();
+
+		                    cout << "Sphere Resolution = " << g_nPrecision << endl;
+		                    break;
+
+		                case XK_F2:
+		                    if( g_nPrecision + 2 <= MAX_PRECISION )
+		                        g_nPrecision += 2;
+
+		                    rebuildSphereInBackground();
+
+		                    cout << "Sphere Resolution = " << g_nPrecision << endl;
+		                    break;
+
+		                case XK_F3:
+		                    g_nCurrentMode = IMMEDIATE_MODE;
+		                    cout << "Render Method: Immediate Mode" << endl;
+		                    rebuildSphere();
+		                    break;
+
+		                case XK_F4:
+		                    g_nCurrentMode = DISPLAY_LIST;
+		                    rebuildSphere();
+		                    cout << "Render Method: Display List" << endl;
+		                    break;
+
+		                case XK_F5:
+		                    g_nCurrentMode = VERTEX_ARRAY;
+		                    rebuildSphere();
+		                    cout << "Render Method: Vertex Array" << endl;
+		                    break;
+
+		                case XK_F8:
+		                    g_nCurrentMode = VERTEX_BUFFER;
+		                    rebuildSphere();
+		                    cout << "Render Method: Vertex Buffer Object" << endl;
+		                    break;
+
+		                case XK_F9:
+		                    g_nSphereLayout = (g_nSphereLayout + 1) % NUM_LAYOUTS;
+		                    rebuildSphere();
+		                    cout << "Vertex Layout: " << getLayoutName( g_nSphereLayout ) << endl;
+		                    break;
+
+		                case XK_F10:
+		                    g_nVertexFormat = (g_nVertexFormat + 1) % NUM_VERTEX_FORMATS;
+		                    rebuildSphere();
+		                    cout << "Vertex Format: " << getVertexFormatName( g_nVertexFormat ) << endl;
+		                    break;
+
+		                case XK_F11:
+		                    g_nCurrentMode = STREAMING_MODE;
+		                    rebuildSphere();
+		                    cout << "Render Method: Streaming" << endl;
+		                    break;
+
+		                case XK_p:
+		                    g_nCurrentMode = PROCEDURAL;
+		                    rebuildSphere();
+		                    cout << "Render Method: Procedural" << endl;
+		                    break;
+
+		                case XK_i:
+		                    g_nCurrentMode = IMPOSTOR_MODE;
+		                    rebuildSphere();
+		                    cout << "Render Method: Impostor" << endl;
+		                    break;
+
+		                case XK_t:
+		                    g_nCurrentMode = SOFTWARE_TNL;
+		                    rebuildSphere();
+		                    cout << "Render Method: Software T&L (" 
+		                         << getSphereKernelKey( g_nSphereKernel ) << ")" << endl;
+		                    break;
+
+		                case XK_l:
+		                    g_bAdaptiveLOD = !g_bAdaptiveLOD;
+		                    g_nLODFrames   = 0;
+		                    cout << "Adaptive LOD: " << (g_bAdaptiveLOD ? "On" : "Off") 
+		                         << " (" << g_fLODTargetTime << " ms budget)" << endl;
+		                    break;
+
+		                case XK_c:
+		                    g_bBandCulling = !g_bBandCulling;
+		                    rebuildSphere();
+		                    cout << "Band Culling: " << (g_bBandCulling ? "On" : "Off") << endl;
+		                    break;
+
+		                case XK_b:
+		                    g_bBandStrips = !g_bBandStrips;
+		                    rebuildSphere();
+		                    cout << "Band Strips: " << (g_bBandStrips ? "On" : "Off") << endl;
+		                    break;
+
+		                case XK_m:
+		                    g_bMipmaps = !g_bMipmaps;
+		                    setTextureFilter();
+		                    cout << "Mipmaps: " << (g_bMipmaps ? "On" : "Off") << endl;
+		                    break;
+
+		                case XK_F12:
+		                    g_bBackgroundRebuild = !g_bBackgroundRebuild;
+		                    cout << "Background Rebuild: " << (g_bBackgroundRebuild ? "On" : "Off") << endl;
+		                    break;
 
 	  		             case XK_F6:
 	   		                 cout << endl;
@@ -330,7 +1169,11 @@ int main( int argc, char **argv )
 		
 					glMatrixMode( GL_PROJECTION );
 					glLoadIdentity();
-					gluPerspective( 45.0, (GLdouble)nWidth / (GLdouble)nHeight, 0.1, 100.0);
+					gluPerspective( FIELD_OF_VIEW, (GLdouble)nWidth / (GLdouble)nHeight, 0.1, 100.0);
+
+					// The LOD controller needs the size of the sphere on screen
+					g_nWindowWidth  = nWidth;
+					g_nWindowHeight = nHeight;
                 }
                 break;
 
@@ -342,6 +1185,17 @@ int main( int argc, char **argv )
             }
         }
 
+        // Swap in a sphere the builder thread has finished, if any
+        updateSphereBuilder( false );
+
+        // The time from one frame to the next, presenting included
+        uint64_t nFrameStart = getTimeNanoseconds();
+
+        if( nLastFrameStart != 0 )
+            updateLODController( (nFrameStart - nLastFrameStart) / 1000000.0f );
+
+        nLastFrameStart = nFrameStart;
+
         render();
     }
 
@@ -361,454 +1215,5662 @@ void init( void )
 	glEnable( GL_TEXTURE_2D );
 	glEnable( GL_DEPTH_TEST );
 
-    loadTexture();
-
 	glMatrixMode( GL_PROJECTION );
 	glLoadIdentity();
-	gluPerspective( 45.0f, 640.0f / 480.0f, 0.1f, 100.0f );
+	gluPerspective( FIELD_OF_VIEW, (float)g_nWindowWidth / (float)g_nWindowHeight, 0.1f, 100.0f );
+
+    if( g_nGenerationThreads <= 0 )
+        g_nGenerationThreads = getNumProcessors();
+
+    g_nGenerationThreads = min( g_nGenerationThreads, MAX_GENERATION_THREADS );
+    createThreadPool( g_nGenerationThreads );
+
+    // After the thread pool, which resamples a large texture
+    loadTexture();
+
+    createSphereInstances();
+    createFrameTimers();
 
     //
     // Create the first sphere...
     //
 
-    // Inform the user of the current mode
-    cout << "Render Method: Immediate Mode" << endl;
-
-    createSphereGeometry( 0.0f, 0.0f, 0.0f, 1.5f, g_nPrecision );
-}
+    // Inform the user of the current mode, unless stdout is reserved for the
+    // headless report.
+    if( !g_bHeadless )
+        cout << "Render Method: " << getRenderModeName( g_nCurrentMode ) << endl;
 
-//-----------------------------------------------------------------------------
-// Name: shutDown()
-// Desc: 
-//-----------------------------------------------------------------------------
-void shutDown( void )	
-{
-    glDeleteTextures( 1, &g_textureID );
-    glDeleteLists( g_sphereDList, 0 );
+    rebuildSphere();
 
-    if( g_glxContext != NULL )
-    {
-        // Release the context
-        glXMakeCurrent( g_pDisplay, None, NULL );
+    g_fStartupTime = (getTimeNanoseconds() - g_nStartTime) / 1000000.0f;
 
-        // Delete the context
-        glXDestroyContext( g_pDisplay, g_glxContext );
-        g_glxContext = NULL;
-    }
+    if( !g_bHeadless )
+        cout << "Startup Time: " << g_fStartupTime << " ms (" << g_nMeshFilesLoaded 
+             << " mesh files loaded, " << g_nMeshFilesWritten << " written)" << endl;
 }
 
 //-----------------------------------------------------------------------------
-// Name: getBitmapImageData()
-// Desc: Simply image loader for 24 bit BMP files.
+// Name: parseCommandLine()
+// Desc: Picks up the benchmark settings. Returns false on a bad argument.
 //-----------------------------------------------------------------------------
-void getBitmapImageData( char *pFileName, BMPImage *pImage )
+bool parseCommandLine( int argc, char **argv )
 {
-    FILE *pFile = NULL;
-    unsigned short nNumPlanes;
-    unsigned short nNumBPP;
-	int i;
+    for( int i = 1; i < argc; ++i )
+    {
+        const char *pArg   = argv[i];
+        const char *pValue = (i + 1 < argc) ? argv[i + 1] : NULL;
 
-    if( (pFile = fopen(pFileName, "rb") ) == NULL )
-		cout << "ERROR: getBitmapImageData - %s not found " << pFileName << "." << endl;
+        if( strcmp( pArg, "--headless" ) == 0 )
+        {
+            g_bHeadless = true;
+            continue;
+        }
 
-    // Seek forward to width and height info
-    fseek( pFile, 18, SEEK_CUR );
+        if( strcmp( pArg, "--instanced" ) == 0 )
+        {
+            g_bInstancedScene = true;
+            continue;
+        }
 
-    if( (i = fread(&pImage->width, 4, 1, pFile) ) != 1 )
-		cout << "ERROR: getBitmapImageData - Couldn't read width from " << pFileName << "." << endl; 
+        if( strcmp( pArg, "--cull" ) == 0 )
+        {
+            g_bBandCulling = true;
+            continue;
+        }
 
-    if( (i = fread(&pImage->height, 4, 1, pFile) ) != 1 )
-		cout << "ERROR: getBitmapImageData - Couldn't read height from " << pFileName << "." << endl; 
+        if( strcmp( pArg, "--band-strips" ) == 0 )
+        {
+            g_bBandStrips = true;
+            continue;
+        }
 
-    if( (fread(&nNumPlanes, 2, 1, pFile) ) != 1 )
-		cout << "ERROR: getBitmapImageData - Couldn't read plane count from " << pFileName << "." << endl; 
-	
-    if( nNumPlanes != 1 )
-		cout << "ERROR: getBitmapImageData - Plane count from " << pFileName << " is not 1: " << nNumPlanes << "." << endl;
+        if( strcmp( pArg, "--direct-upload" ) == 0 )
+        {
+            g_bDirectTextureUpload = true;
+            continue;
+        }
 
-    if( (i = fread(&nNumBPP, 2, 1, pFile)) != 1 )
-		cout << "ERROR: getBitmapImageData - Couldn't read BPP from " << pFileName << endl; 
-	
-    if( nNumBPP != 24 )
-		cout << "ERROR: getBitmapImageData - BPP from " << pFileName << " is not 24: " << nNumBPP << "." << endl;
+        if( strcmp( pArg, "--no-mipmaps" ) == 0 )
+        {
+            g_bMipmaps = false;
+            continue;
+        }
 
-    // Seek forward to image data
-    fseek( pFile, 24, SEEK_CUR );
+        if( strcmp( pArg, "--generation-scaling" ) == 0 )
+        {
+            g_bGenerationScaling = true;
+            continue;
+        }
 
-	// Calculate the image's total size in bytes. Note how we multiply the 
-	// result of (width * height) by 3. This is becuase a 24 bit color BMP 
-	// file will give you 3 bytes per pixel.
-    int nTotalImagesize = (pImage->width * pImage->height) * 3;
+        if( strcmp( pArg, "--compare-mipmaps" ) == 0 )
+        {
+            g_bCompareMipmaps = true;
+            continue;
+        }
 
-    pImage->data = (char*) malloc( nTotalImagesize );
-	
-    if( (i = fread(pImage->data, nTotalImagesize, 1, pFile) ) != 1 )
-		cout << "ERROR: getBitmapImageData - Couldn't read image data from " << pFileName << "." << endl;
+        // Everything else takes a value
+        if( pValue == NULL )
+        {
+            cerr << "ERROR: parseCommandLine - " << pArg << " needs a value." << endl;
+            return false;
+        }
 
-    //
-	// Finally, rearrange BGR to RGB
-	//
-	
-	char charTemp;
-    for( i = 0; i < nTotalImagesize; i += 3 )
-	{ 
-		charTemp = pImage->data[i];
-		pImage->data[i] = pImage->data[i+2];
-		pImage->data[i+2] = charTemp;
-    }
-}
+        ++i;
 
-//-----------------------------------------------------------------------------
-// Name: loadTexture()
-// Desc: 
-//-----------------------------------------------------------------------------
-void loadTexture( void )	
-{
-	BMPImage textureImage;
-	
-    getBitmapImageData( "mars.bmp", &textureImage );
+        if( strcmp( pArg, "--mode" ) == 0 )
+        {
+            GLuint nMode;
+            for( nMode = 0; nMode < NUM_RENDER_MODES; ++nMode )
+            {
+                if( strcmp( pValue, getRenderModeKey( nMode ) ) == 0 )
+                    break;
+            }
 
-	glGenTextures( 1, &g_textureID );
-	glBindTexture( GL_TEXTURE_2D, g_textureID );
+            if( nMode == NUM_RENDER_MODES )
+            {
+                cerr << "ERROR: parseCommandLine - Unknown mode " << pValue << "." << endl;
+                return false;
+            }
 
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+            g_nCurrentMode = nMode;
+        }
+        else if( strcmp( pArg, "--layout" ) == 0 )
+        {
+            GLuint nLayout;
+            for( nLayout = 0; nLayout < NUM_LAYOUTS; ++nLayout )
+            {
+                if( strcmp( pValue, getLayoutKey( nLayout ) ) == 0 )
+                    break;
+            }
 
-	glTexImage2D( GL_TEXTURE_2D, 0, 3, textureImage.width, textureImage.height, 
-	               0, GL_RGB, GL_UNSIGNED_BYTE, textureImage.data );
-}
+            if( nLayout == NUM_LAYOUTS )
+            {
+                cerr << "ERROR: parseCommandLine - Unknown layout " << pValue << "." << endl;
+                return false;
+            }
 
-//-----------------------------------------------------------------------------
-// Name: renderSphere()
-// Desc: Create a sphere centered at cy, cx, cz with radius r, and 
-//       precision p. Based on a function Written by Paul Bourke. 
-//       http://astronomy.swin.edu.au/~pbourke/opengl/sphere/
-//-----------------------------------------------------------------------------
-void renderSphere( float cx, float cy, float cz, float r, int p )
-{
-    const float TWOPI  = 6.28318530717958f;
-    const float PIDIV2 = 1.57079632679489f;
+            g_nSphereLayout = nLayout;
+        }
+        else if( strcmp( pArg, "--format" ) == 0 )
+        {
+            GLuint nFormat;
+            for( nFormat = 0; nFormat < NUM_VERTEX_FORMATS; ++nFormat )
+            {
+                if( strcmp( pValue, getVertexFormatKey( nFormat ) ) == 0 )
+                    break;
+            }
 
-    float theta1 = 0.0;
-    float theta2 = 0.0;
-    float theta3 = 0.0;
+            if( nFormat == NUM_VERTEX_FORMATS )
+            {
+                cerr << "ERROR: parseCommandLine - Unknown vertex format " << pValue << "." << endl;
+                return false;
+            }
 
-    float ex = 0.0f;
-    float ey = 0.0f;
-    float ez = 0.0f;
+            g_nVertexFormat = nFormat;
+        }
+        else if( strcmp( pArg, "--kernel" ) == 0 )
+        {
+            int nKernel;
+            for( nKernel = 0; nKernel < NUM_SPHERE_KERNELS; ++nKernel )
+            {
+                if( strcmp( pValue, getSphereKernelKey( nKernel ) ) == 0 )
+                    break;
+            }
 
-    float px = 0.0f;
-    float py = 0.0f;
-    float pz = 0.0f;
+            if( nKernel == NUM_SPHERE_KERNELS )
+            {
+                cerr << "ERROR: parseCommandLine - Unknown kernel " << pValue << "." << endl;
+                return false;
+            }
 
-    // Disallow a negative number for radius.
-    if( r < 0 )
-        r = -r;
+            if( !isSphereKernelSupported( nKernel ) )
+            {
+                cerr << "ERROR: parseCommandLine - The " << pValue << " kernel isn't supported by this CPU." << endl;
+                return false;
+            }
 
-    // Disallow a negative number for precision.
-    if( p < 0 )
-        p = -p;
+            g_nSphereKernel = nKernel;
+        }
+        else if( strcmp( pArg, "--threads" ) == 0 )
+            g_nGenerationThreads = atoi( pValue );
+        else if( strcmp( pArg, "--cache-size" ) == 0 )
+            g_nVertexCacheSize = atoi( pValue );
+        else if( strcmp( pArg, "--mesh-cache-mb" ) == 0 )
+            g_nMeshCacheBudget = (size_t)max( atoi( pValue ), 0 ) * 1024 * 1024;
+        else if( strcmp( pArg, "--mesh-dir" ) == 0 )
+            g_pMeshFileDir = pValue;
+        else if( strcmp( pArg, "--precision" ) == 0 )
+        {
+            // Parsed signed, so a negative precision can't wrap around
+            int nPrecision = atoi( pValue );
 
-    // If the sphere is too small, just render a OpenGL point instead.
-    if( p < 4 || r <= 0 ) 
-    {
-        glBegin( GL_POINTS );
-        glVertex3f( cx, cy, cz );
-        glEnd();
-        return;
-    }
+            if( nPrecision < MIN_PRECISION || nPrecision > MAX_PRECISION )
+            {
+                cerr << "ERROR: parseCommandLine - Precision must be " << MIN_PRECISION 
+                     << " to " << MAX_PRECISION << "." << endl;
+                return false;
+            }
 
-    for( int i = 0; i < p/2; ++i )
-    {
-        theta1 = i * TWOPI / p - PIDIV2;
-        theta2 = (i + 1) * TWOPI / p - PIDIV2;
+            g_nPrecision = nPrecision;
+        }
+        else if( strcmp( pArg, "--frames" ) == 0 )
+            g_nBenchmarkFrames = atoi( pValue );
+        else if( strcmp( pArg, "--warmup" ) == 0 )
+            g_nWarmUpFrames = atoi( pValue );
+        else if( strcmp( pArg, "--width" ) == 0 )
+            g_nWindowWidth = atoi( pValue );
+        else if( strcmp( pArg, "--height" ) == 0 )
+            g_nWindowHeight = atoi( pValue );
+        else if( strcmp( pArg, "--sweep" ) == 0 )
+        {
+            if( !parsePrecisionList( pValue ) )
+                return false;
 
-        glBegin( GL_TRIANGLE_STRIP );
+            // The sweep is meant for machines without a display
+            g_bHeadless  = true;
+            g_nPrecision = g_anSweepPrecisions[0];
+        }
+        else if( strcmp( pArg, "--csv" ) == 0 )
+            g_pSweepCSVFile = pValue;
+        else if( strcmp( pArg, "--baseline" ) == 0 )
+            g_pBaselineFile = pValue;
+        else if( strcmp( pArg, "--threshold" ) == 0 )
+            g_fRegressionPercent = (float)atof( pValue );
+        else if( strcmp( pArg, "--spheres" ) == 0 )
+            g_nNumSpheres = atoi( pValue );
+        else if( strcmp( pArg, "--target-ms" ) == 0 )
         {
-            for( int j = 0; j <= p; ++j )
-            {
-                theta3 = j * TWOPI / p;
-
-                ex = cosf(theta2) * cosf(theta3);
-                ey = sinf(theta2);
-                ez = cosf(theta2) * sinf(theta3);
-                px = cx + r * ex;
-                py = cy + r * ey;
-                pz = cz + r * ez;
-
-                glNormal3f( ex, ey, ez );
-                glTexCoord2f( -(j/(float)p) , 2*(i+1)/(float)p );
-                glVertex3f( px, py, pz );
-
-                ex = cosf(theta1) * cosf(theta3);
-                ey = sinf(theta1);
-                ez = cosf(theta1) * sinf(theta3);
-                px = cx + r * ex;
-                py = cy + r * ey;
-                pz = cz + r * ez;
-
-                glNormal3f( ex, ey, ez );
-                glTexCoord2f( -(j/(float)p), 2*i/(float)p );
-                glVertex3f( px, py, pz );
-            }
+            g_bAdaptiveLOD   = true;
+            g_fLODTargetTime = (float)atof( pValue );
+        }
+        else if( strcmp( pArg, "--scaling" ) == 0 )
+            g_nScalingThreads = atoi( pValue );
+        else if( strcmp( pArg, "--texture-size" ) == 0 )
+            g_nTextureSize = atoi( pValue );
+        else
+        {
+            cerr << "ERROR: parseCommandLine - Unknown option " << pArg << "." << endl;
+            return false;
         }
-        glEnd();
     }
-}
-
-//-----------------------------------------------------------------------------
-// Name: createSphereDisplayList()
-// Desc: Build Sphere Display List
-//-----------------------------------------------------------------------------
-void createSphereDisplayList()
-{
-    glDeleteLists( g_sphereDList, 0 );
 
-    static bool firstPass = true;
-
-    if( firstPass )
+    if( g_nPrecision < 4 || g_nBenchmarkFrames <= 0 || g_nWarmUpFrames < 0 ||
+        g_nWindowWidth <= 0 || g_nWindowHeight <= 0 || g_nVertexCacheSize <= 0 )
     {
-        g_sphereDList = glGenLists(1);
-        firstPass     = false;
+        cerr << "ERROR: parseCommandLine - Precision must be at least 4 and "
+             << "frames, width, height and cache size must be positive." << endl;
+        return false;
     }
 
-    if( g_sphereDList != 0 )
+    if( g_nTextureSize < 0 )
     {
-        glNewList( g_sphereDList, GL_COMPILE );
-        // Cache the calls needed to render a sphere
-        renderSphere( 0.0f, 0.0f, 0.0f, 1.5f, g_nPrecision );
-        glEndList();
+        cerr << "ERROR: parseCommandLine - The texture size can't be negative." << endl;
+        return false;
     }
-}
 
+    if( g_nNumSpheres < 1 || g_nNumSpheres > MAX_SPHERES )
+    {
+        cerr << "ERROR: parseCommandLine - There can be 1 to " << MAX_SPHERES << " spheres." << endl;
+        return false;
+    }
+
+    if( g_bAdaptiveLOD && (g_fLODTargetTime <= 0.0f || g_nNumSweepPrecisions > 0) )
+    {
+        cerr << "ERROR: parseCommandLine - --target-ms must be positive, and the "
+             << "sweep benchmarks fixed precisions." << endl;
+        return false;
+    }
+
+    // The worker threads only read the sphere, and draw nothing that has 
+    // per-frame state of its own
+    if( g_nScalingThreads != 0 && 
+        (g_nScalingThreads < 0 || g_nScalingThreads > MAX_SCALING_THREADS ||
+         g_nNumSweepPrecisions > 0 || g_bAdaptiveLOD || g_bInstancedScene || g_bBandCulling ||
+         (g_nCurrentMode != IMMEDIATE_MODE && g_nCurrentMode != DISPLAY_LIST &&
+          g_nCurrentMode != VERTEX_ARRAY && g_nCurrentMode != VERTEX_BUFFER)) )
+    {
+        cerr << "ERROR: parseCommandLine - --scaling takes 1 to " << MAX_SCALING_THREADS 
+             << " threads, one of the immediate, display_list, vertex_array and "
+             << "vertex_buffer modes, and none of --sweep, --target-ms, --instanced "
+             << "or --cull." << endl;
+        return false;
+    }
+
+    if( (g_pSweepCSVFile != NULL || g_pBaselineFile != NULL) && g_nNumSweepPrecisions == 0 )
+    {
+        cerr << "ERROR: parseCommandLine - --csv and --baseline need --sweep." << endl;
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: parsePrecisionList()
+// Desc: Reads the comma separated precisions given to --sweep.
+//-----------------------------------------------------------------------------
+bool parsePrecisionList( const char *pList )
+{
+    g_nNumSweepPrecisions = 0;
+
+    while( *pList != '\0' )
+    {
+        char *pEnd;
+        long  nPrecision = strtol( pList, &pEnd, 10 );
+
+        if( pEnd == pList || nPrecision < MIN_PRECISION || nPrecision > MAX_PRECISION ||
+            (*pEnd != ',' && *pEnd != '\0') )
+        {
+            cerr << "ERROR: parsePrecisionList - Bad precision list " << pList << "." << endl;
+            return false;
+        }
+
+        if( g_nNumSweepPrecisions == MAX_SWEEP_PRECISIONS )
+        {
+            cerr << "ERROR: parsePrecisionList - At most " << MAX_SWEEP_PRECISIONS 
+                 << " precisions can be swept." << endl;
+            return false;
+        }
+
+        g_anSweepPrecisions[g_nNumSweepPrecisions++] = (GLuint)nPrecision;
+
+        pList = (*pEnd == ',') ? pEnd + 1 : pEnd;
+    }
+
+    return g_nNumSweepPrecisions > 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: printUsage()
+// Desc: 
+//-----------------------------------------------------------------------------
+void printUsage( const char *pProgramName )
+{
+    cerr << "Usage: " << pProgramName << " [--headless] [--mode <name>] [--layout <name>] [--precision <n>]" << endl;
+    cerr << "       [--format <name>] [--kernel <name>] [--threads <n>] [--cache-size <n>]" << endl;
+    cerr << "       [--mesh-cache-mb <n>] [--mesh-dir <dir>]" << endl;
+    cerr << "       [--frames <n>] [--warmup <n>] [--width <n>] [--height <n>]" << endl;
+    cerr << "       [--sweep <p,p,...>] [--csv <file>] [--baseline <file>] [--threshold <pct>]" << endl;
+    cerr << "       [--spheres <n>] [--instanced] [--target-ms <ms>] [--cull] [--band-strips]" << endl;
+    cerr << "       [--scaling <n>] [--texture-size <n>] [--direct-upload] [--no-mipmaps]" << endl;
+    cerr << "       [--compare-mipmaps] [--generation-scaling]" << endl;
+    cerr << "Modes:";
+
+    for( GLuint nMode = 0; nMode < NUM_RENDER_MODES; ++nMode )
+        cerr << " " << getRenderModeKey( nMode );
+
+    cerr << endl;
+    cerr << "Layouts:";
+
+    for( GLuint nLayout = 0; nLayout < NUM_LAYOUTS; ++nLayout )
+        cerr << " " << getLayoutKey( nLayout );
+
+    cerr << endl;
+    cerr << "Formats:";
+
+    for( GLuint nFormat = 0; nFormat < NUM_VERTEX_FORMATS; ++nFormat )
+        cerr << " " << getVertexFormatKey( nFormat );
+
+    cerr << endl;
+    cerr << "Kernels:";
+
+    for( int nKernel = 0; nKernel < NUM_SPHERE_KERNELS; ++nKernel )
+    {
+        if( isSphereKernelSupported( nKernel ) )
+            cerr << " " << getSphereKernelKey( nKernel );
+    }
+
+    cerr << endl;
+}
+
+//-----------------------------------------------------------------------------
+// Name: shutDown()
+// Desc: 
+//-----------------------------------------------------------------------------
+void shutDown( void )	
+{
+    glDeleteTextures( 1, &g_textureID );
+
+    updateSphereBuilder( true );
+
+    SphereMesh mesh;
+    detachSphereMesh( &mesh );
+    freeSphereMesh( &mesh );
+    clearMeshCache();
+
+    glDeleteBuffers( NUM_STREAM_BUFFERS, g_streamVBOs );
+    destroySphereTables( &g_streamTables );
+
+    glDeleteProgram( g_proceduralProgram );
+    glDeleteProgram( g_impostorProgram );
+    destroyCullCones();
+    destroyBandStrips();
+    destroyFrameTimers();
+
+    free( g_pTransformedVertices );
+    g_pTransformedVertices    = NULL;
+    g_nMaxTransformedVertices = 0;
+
+    glDeleteBuffers( 1, &g_instanceVBO );
+    glDeleteProgram( g_instanceProgram );
+    delete []g_pSphereInstances;
+    g_pSphereInstances = NULL;
+
+    destroyThreadPool();
+
+    if( g_eglContext != EGL_NO_CONTEXT )
+    {
+        eglMakeCurrent( g_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+        eglDestroyContext( g_eglDisplay, g_eglContext );
+        eglDestroySurface( g_eglDisplay, g_eglSurface );
+        eglTerminate( g_eglDisplay );
+        g_eglContext = EGL_NO_CONTEXT;
+    }
+
+    if( g_glxContext != NULL )
+    {
+        // Release the context
+        glXMakeCurrent( g_pDisplay, None, NULL );
+
+        // Delete the context
+        glXDestroyContext( g_pDisplay, g_glxContext );
+        g_glxContext = NULL;
+    }
+
+    if( g_glxPbuffer != 0 )
+    {
+        glXDestroyPbuffer( g_pDisplay, g_glxPbuffer );
+        g_glxPbuffer = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: initHeadlessContext()
+// Desc: Creates a p-buffer and a desktop OpenGL context through EGL. Mesa's 
+//       surfaceless platform needs neither an X server nor a GPU, so this 
+//       runs on llvmpipe. Returns false if no context could be made.
+//-----------------------------------------------------------------------------
+bool initHeadlessContext( void )
+{
+    PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = 
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+
+    if( eglGetPlatformDisplayEXT != NULL )
+        g_eglDisplay = eglGetPlatformDisplayEXT( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL );
+
+    // Fall back to whatever platform EGL picks by default
+    if( g_eglDisplay == EGL_NO_DISPLAY )
+        g_eglDisplay = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+
+    EGLint nMajor;
+    EGLint nMinor;
+
+    if( g_eglDisplay == EGL_NO_DISPLAY || !eglInitialize( g_eglDisplay, &nMajor, &nMinor ) )
+    {
+        cerr << "ERROR: initHeadlessContext - Couldn't initialize EGL" << endl;
+        return false;
+    }
+
+    EGLint configAttrib[] =
+    {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT, // Needs to support p-buffers
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,  // Needs to support desktop OpenGL
+        EGL_RED_SIZE,        8,
+        EGL_GREEN_SIZE,      8,
+        EGL_BLUE_SIZE,       8,
+        EGL_DEPTH_SIZE,      16,              // Needs to support a 16 bit depth buffer
+        EGL_NONE                              // end of list
+    };
+
+    EGLint pbufferAttrib[] =
+    {
+        EGL_WIDTH,  g_nWindowWidth,
+        EGL_HEIGHT, g_nWindowHeight,
+        EGL_NONE
+    };
+
+    EGLint nNumConfigs = 0;
+
+    if( !eglChooseConfig( g_eglDisplay, configAttrib, &g_eglConfig, 1, &nNumConfigs ) || 
+        nNumConfigs == 0 )
+    {
+        cerr << "ERROR: initHeadlessContext - Couldn't get an EGL config" << endl;
+        return false;
+    }
+
+    g_eglSurface = eglCreatePbufferSurface( g_eglDisplay, g_eglConfig, pbufferAttrib );
+
+    if( g_eglSurface == EGL_NO_SURFACE )
+    {
+        cerr << "ERROR: initHeadlessContext - Couldn't create a p-buffer" << endl;
+        return false;
+    }
+
+    // The sample is written against the fixed-function pipeline
+    eglBindAPI( EGL_OPENGL_API );
+
+    g_eglContext = eglCreateContext( g_eglDisplay, g_eglConfig, EGL_NO_CONTEXT, NULL );
+
+    if( g_eglContext == EGL_NO_CONTEXT )
+    {
+        cerr << "ERROR: initHeadlessContext - Call to eglCreateContext failed!" << endl;
+        return false;
+    }
+
+    if( !eglMakeCurrent( g_eglDisplay, g_eglSurface, g_eglSurface, g_eglContext ) )
+    {
+        cerr << "ERROR: initHeadlessContext - Call to eglMakeCurrent failed!" << endl;
+        return false;
+    }
+
+    glViewport( 0, 0, g_nWindowWidth, g_nWindowHeight );
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: runHeadlessBenchmark()
+// Desc: Benchmarks the mode picked on the command line and prints the 
+//       result as JSON. Returns the process exit code.
+//-----------------------------------------------------------------------------
+int runHeadlessBenchmark( void )
+{
+    if( !initHeadlessContext() )
+    {
+        shutDown();
+        return 1;
+    }
+
+    init();
+
+    if( g_nNumSweepPrecisions > 0 )
+    {
+        int nExitCode = runSweepBenchmark();
+        shutDown();
+
+        return nExitCode;
+    }
+
+    BenchmarkResult result;
+    runBenchmark( &result );
+    printBenchmarkJSON( &result );
+
+    shutDown();
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: runSweepBenchmark()
+// Desc: Benchmarks every render mode at every precision given to --sweep, 
+//       prints the matrix as a JSON array, and optionally writes it as CSV 
+//       and checks it against a baseline. Returns the process exit code.
+//-----------------------------------------------------------------------------
+int runSweepBenchmark( void )
+{
+    int              nNumResults = g_nNumSweepPrecisions * NUM_RENDER_MODES;
+    BenchmarkResult *pResults    = new BenchmarkResult[nNumResults];
+    int              k           = 0;
+
+    // Every mode at one precision before the next, so the modes that share 
+    // a mesh find it in the cache
+    for( int i = 0; i < g_nNumSweepPrecisions; ++i )
+    {
+        for( GLuint nMode = 0; nMode < NUM_RENDER_MODES; ++nMode )
+        {
+            g_nPrecision   = g_anSweepPrecisions[i];
+            g_nCurrentMode = nMode;
+            rebuildSphere();
+
+            cerr << "Sweep: " << getRenderModeKey( nMode ) << " at precision " 
+                 << g_nPrecision << endl;
+
+            runBenchmark( &pResults[k++] );
+        }
+    }
+
+    printf( "[\n" );
+
+    for( k = 0; k < nNumResults; ++k )
+    {
+        if( k > 0 )
+            printf( ",\n" );
+
+        printBenchmarkJSON( &pResults[k] );
+    }
+
+    printf( "]\n" );
+
+    int nExitCode = 0;
+
+    if( g_pSweepCSVFile != NULL && !writeBenchmarkCSV( g_pSweepCSVFile, pResults, nNumResults ) )
+        nExitCode = 1;
+
+    if( g_pBaselineFile != NULL )
+    {
+        int nNumRegressions = compareWithBaseline( g_pBaselineFile, pResults, nNumResults );
+
+        if( nNumRegressions < 0 )
+            nExitCode = 1;
+        else if( nNumRegressions > 0 )
+            nExitCode = 2;
+    }
+
+    delete []pResults;
+
+    return nExitCode;
+}
+
+//-----------------------------------------------------------------------------
+// Name: runScalingBenchmark()
+// Desc: Renders the current sphere from 1, 2, ... g_nScalingThreads threads
+//       at once and reports how the frame rate scales, as text or, with
+//       --headless, as JSON. Returns the process exit code.
+//-----------------------------------------------------------------------------
+int runScalingBenchmark( void )
+{
+    bool bContext = g_bHeadless ? initHeadlessContext() : initPbufferContext();
+
+    if( !bContext )
+    {
+        shutDown();
+        return 1;
+    }
+
+    init();
+
+    ScalingResult *pResults = new ScalingResult[g_nScalingThreads];
+    int            nExitCode = 0;
+
+    for( int n = 1; n <= g_nScalingThreads; ++n )
+    {
+        cerr << "Scaling: " << n << (n == 1 ? " thread" : " threads") << endl;
+
+        runScalingThreads( n, &pResults[n - 1] );
+
+        if( pResults[n - 1].nNumFailed > 0 )
+            nExitCode = 1;
+    }
+
+    if( g_bHeadless )
+        printScalingJSON( pResults, g_nScalingThreads );
+    else
+        printScalingReport( pResults, g_nScalingThreads );
+
+    delete []pResults;
+
+    shutDown();
+
+    return nExitCode;
+}
+
+//-----------------------------------------------------------------------------
+// Name: initPbufferContext()
+// Desc: The GLX counterpart of initHeadlessContext(), for the scaling
+//       benchmark. Every thread shares the one X connection, so Xlib has
+//       to be told to expect that before anything else touches it.
+//-----------------------------------------------------------------------------
+bool initPbufferContext( void )
+{
+    XInitThreads();
+
+    g_pDisplay = XOpenDisplay( NULL );
+
+    if( g_pDisplay == NULL )
+    {
+        cerr << "ERROR: initPbufferContext - Couldn't open the display" << endl;
+        return false;
+    }
+
+    int errorBase;
+    int eventBase;
+
+    if( !glXQueryExtension( g_pDisplay, &errorBase, &eventBase ) ||
+        !createPbufferContext( NULL, &g_glxPbuffer, &g_glxContext ) )
+    {
+        return false;
+    }
+
+    glXMakeCurrent( g_pDisplay, g_glxPbuffer, g_glxContext );
+    glViewport( 0, 0, g_nWindowWidth, g_nWindowHeight );
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: createPbufferContext()
+// Desc: Creates a p-buffer the size of the window, and a context for it
+//       that shares display lists, textures and buffers with shareContext,
+//       the same way OffScreen_Rendering does.
+//-----------------------------------------------------------------------------
+bool createPbufferContext( GLXContext shareContext, GLXPbuffer *pPbuffer, GLXContext *pContext )
+{
+    GLXFBConfig *fbconfig;
+    XVisualInfo *visinfo;
+    int nitems;
+
+    int attrib[] =
+    {
+        GLX_DOUBLEBUFFER,  False,
+        GLX_RED_SIZE,      1,
+        GLX_GREEN_SIZE,    1,
+        GLX_BLUE_SIZE,     1,
+        GLX_DEPTH_SIZE,    1,
+        GLX_RENDER_TYPE,   GLX_RGBA_BIT,
+        GLX_DRAWABLE_TYPE, GLX_PBUFFER_BIT | GLX_WINDOW_BIT,
+        None
+    };
+
+    int pbufAttrib[] =
+    {
+        GLX_PBUFFER_WIDTH,   g_nWindowWidth,
+        GLX_PBUFFER_HEIGHT,  g_nWindowHeight,
+        GLX_LARGEST_PBUFFER, False,
+        None
+    };
+
+    fbconfig = glXChooseFBConfig( g_pDisplay, DefaultScreen( g_pDisplay ), attrib, &nitems );
+
+    if( fbconfig == NULL )
+    {
+        cerr << "ERROR: createPbufferContext - Couldn't get fbconfig" << endl;
+        return false;
+    }
+
+    *pPbuffer = glXCreatePbuffer( g_pDisplay, fbconfig[0], pbufAttrib );
+    visinfo   = glXGetVisualFromFBConfig( g_pDisplay, fbconfig[0] );
+
+    XFree( fbconfig );
+
+    if( visinfo == NULL )
+    {
+        cerr << "ERROR: createPbufferContext - Couldn't get an RGBA visual" << endl;
+        glXDestroyPbuffer( g_pDisplay, *pPbuffer );
+        *pPbuffer = 0;
+        return false;
+    }
+
+    *pContext = glXCreateContext( g_pDisplay, visinfo, shareContext, GL_TRUE );
+
+    XFree( visinfo );
+
+    if( *pContext == NULL )
+    {
+        cerr << "ERROR: createPbufferContext - Call to glXCreateContext failed!" << endl;
+        glXDestroyPbuffer( g_pDisplay, *pPbuffer );
+        *pPbuffer = 0;
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: runScalingThreads()
+// Desc: Starts nNumThreads workers, waits for all of them, and gathers what
+//       they measured.
+//-----------------------------------------------------------------------------
+void runScalingThreads( int nNumThreads, ScalingResult *pResult )
+{
+    ScalingWorker *pWorkers = new ScalingWorker[nNumThreads];
+    int            nFrames  = g_nBenchmarkFrames;
+
+    // Sharing with the main context needs it to be current nowhere else
+    if( g_bHeadless )
+        eglMakeCurrent( g_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+    else
+        glXMakeCurrent( g_pDisplay, None, NULL );
+
+    pthread_barrier_init( &g_scalingBarrier, NULL, nNumThreads );
+
+    for( int i = 0; i < nNumThreads; ++i )
+    {
+        pWorkers[i].pFrameTimes = new float[nFrames];
+
+        if( pthread_create( &pWorkers[i].thread, NULL, scalingWorkerMain, &pWorkers[i] ) != 0 )
+        {
+            // Without all of its threads the barrier would never open
+            cerr << "ERROR: runScalingThreads - Couldn't start a thread." << endl;
+            exit( 1 );
+        }
+    }
+
+    for( int i = 0; i < nNumThreads; ++i )
+        pthread_join( pWorkers[i].thread, NULL );
+
+    pthread_barrier_destroy( &g_scalingBarrier );
+
+    if( g_bHeadless )
+        eglMakeCurrent( g_eglDisplay, g_eglSurface, g_eglSurface, g_eglContext );
+    else
+        glXMakeCurrent( g_pDisplay, g_glxPbuffer, g_glxContext );
+
+    uint64_t nFirstStart = 0;
+    uint64_t nLastEnd    = 0;
+    int      nNumFrames  = 0;
+
+    pResult->nNumThreads = nNumThreads;
+    pResult->nNumFailed  = 0;
+
+    for( int i = 0; i < nNumThreads; ++i )
+    {
+        ScalingWorker *pWorker = &pWorkers[i];
+
+        pResult->afMedianFrameTime[i] = 0.0f;
+        pResult->afP95FrameTime[i]    = 0.0f;
+        pResult->afP99FrameTime[i]    = 0.0f;
+        pResult->afMaxFrameTime[i]    = 0.0f;
+
+        if( !pWorker->bReady )
+        {
+            ++pResult->nNumFailed;
+            delete []pWorker->pFrameTimes;
+            continue;
+        }
+
+        if( nNumFrames == 0 || pWorker->nStart < nFirstStart )
+            nFirstStart = pWorker->nStart;
+
+        if( pWorker->nEnd > nLastEnd )
+            nLastEnd = pWorker->nEnd;
+
+        nNumFrames += nFrames;
+
+        sort( pWorker->pFrameTimes, pWorker->pFrameTimes + nFrames );
+
+        pResult->afMedianFrameTime[i] = getPercentile( pWorker->pFrameTimes, nFrames, 50.0f );
+        pResult->afP95FrameTime[i]    = getPercentile( pWorker->pFrameTimes, nFrames, 95.0f );
+        pResult->afP99FrameTime[i]    = getPercentile( pWorker->pFrameTimes, nFrames, 99.0f );
+        pResult->afMaxFrameTime[i]    = pWorker->pFrameTimes[nFrames - 1];
+
+        delete []pWorker->pFrameTimes;
+    }
+
+    pResult->fElapsed         = (nLastEnd - nFirstStart) / 1000000000.0f;
+    pResult->fFramesPerSecond = (nNumFrames > 0) ? nNumFrames / pResult->fElapsed : 0.0f;
+
+    delete []pWorkers;
+}
+
+//-----------------------------------------------------------------------------
+// Name: scalingWorkerMain()
+// Desc: One thread of the scaling benchmark. Makes its own context, then
+//       waits for the others so the timed frames all overlap. A thread
+//       without a context still has to turn up at both barriers.
+//-----------------------------------------------------------------------------
+void *scalingWorkerMain( void *pArg )
+{
+    ScalingWorker *pWorker = (ScalingWorker *)pArg;
+
+    pWorker->bReady = makeScalingContext( pWorker );
+
+    pthread_barrier_wait( &g_scalingBarrier );
+
+    if( pWorker->bReady )
+    {
+        for( int i = 0; i < g_nWarmUpFrames; ++i )
+            renderScalingFrame();
+
+        glFinish();
+    }
+
+    pthread_barrier_wait( &g_scalingBarrier );
+
+    if( !pWorker->bReady )
+        return NULL;
+
+    pWorker->nStart = getTimeNanoseconds();
+
+    for( int i = 0; i < g_nBenchmarkFrames; ++i )
+    {
+        uint64_t nStart = getTimeNanoseconds();
+
+        renderScalingFrame();
+        glFinish();
+
+        pWorker->pFrameTimes[i] = (getTimeNanoseconds() - nStart) / 1000000.0f;
+    }
+
+    pWorker->nEnd = getTimeNanoseconds();
+
+    destroyScalingContext( pWorker );
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: makeScalingContext()
+// Desc: Creates a worker's context and p-buffer, makes them current on the
+//       calling thread and sets them up the way init() does the main one.
+//-----------------------------------------------------------------------------
+bool makeScalingContext( ScalingWorker *pWorker )
+{
+    pWorker->pbuffer    = 0;
+    pWorker->context    = NULL;
+    pWorker->eglSurface = EGL_NO_SURFACE;
+    pWorker->eglContext = EGL_NO_CONTEXT;
+
+    if( g_bHeadless )
+    {
+        EGLint pbufferAttrib[] =
+        {
+            EGL_WIDTH,  g_nWindowWidth,
+            EGL_HEIGHT, g_nWindowHeight,
+            EGL_NONE
+        };
+
+        // The bound API is per thread
+        eglBindAPI( EGL_OPENGL_API );
+
+        pWorker->eglSurface = eglCreatePbufferSurface( g_eglDisplay, g_eglConfig, pbufferAttrib );
+        pWorker->eglContext = eglCreateContext( g_eglDisplay, g_eglConfig, g_eglContext, NULL );
+
+        if( pWorker->eglSurface == EGL_NO_SURFACE || pWorker->eglContext == EGL_NO_CONTEXT ||
+            !eglMakeCurrent( g_eglDisplay, pWorker->eglSurface, pWorker->eglSurface, pWorker->eglContext ) )
+        {
+            cerr << "ERROR: makeScalingContext - Couldn't make an EGL context" << endl;
+            destroyScalingContext( pWorker );
+            return false;
+        }
+    }
+    else
+    {
+        if( !createPbufferContext( g_glxContext, &pWorker->pbuffer, &pWorker->context ) )
+            return false;
+
+        if( !glXMakeCurrent( g_pDisplay, pWorker->pbuffer, pWorker->context ) )
+        {
+            cerr << "ERROR: makeScalingContext - Couldn't make the GLX context current" << endl;
+            destroyScalingContext( pWorker );
+            return false;
+        }
+    }
+
+    glViewport( 0, 0, g_nWindowWidth, g_nWindowHeight );
+    glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+    glEnable( GL_TEXTURE_2D );
+    glEnable( GL_DEPTH_TEST );
+
+    glMatrixMode( GL_PROJECTION );
+    glLoadIdentity();
+    gluPerspective( FIELD_OF_VIEW, (float)g_nWindowWidth / (float)g_nWindowHeight, 0.1f, 100.0f );
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: destroyScalingContext()
+// Desc:
+//-----------------------------------------------------------------------------
+void destroyScalingContext( ScalingWorker *pWorker )
+{
+    if( g_bHeadless )
+    {
+        eglMakeCurrent( g_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+
+        if( pWorker->eglContext != EGL_NO_CONTEXT )
+            eglDestroyContext( g_eglDisplay, pWorker->eglContext );
+
+        if( pWorker->eglSurface != EGL_NO_SURFACE )
+            eglDestroySurface( g_eglDisplay, pWorker->eglSurface );
+
+        // Hands the thread's EGL state back
+        eglReleaseThread();
+    }
+    else
+    {
+        glXMakeCurrent( g_pDisplay, None, NULL );
+        glXDestroyContext( g_pDisplay, pWorker->context );
+        glXDestroyPbuffer( g_pDisplay, pWorker->pbuffer );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: renderScalingFrame()
+// Desc: render() for the scaling benchmark's threads. It draws the same
+//       scene, but leaves out the frame timers and the frame split, which
+//       belong to the main context.
+//-----------------------------------------------------------------------------
+void renderScalingFrame( void )
+{
+    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+
+    glMatrixMode( GL_MODELVIEW );
+    glLoadIdentity();
+    glTranslatef( 0.0f, 0.0f, -VIEW_DISTANCE );
+    glRotatef( -g_fSpinY, 1.0f, 0.0f, 0.0f );
+    glRotatef( -g_fSpinX, 0.0f, 1.0f, 0.0f );
+
+    glBindTexture( GL_TEXTURE_2D, g_textureID );
+
+    drawSphereScene();
+
+    glFlush();
+}
+
+//-----------------------------------------------------------------------------
+// Name: printScalingReport()
+// Desc:
+//-----------------------------------------------------------------------------
+void printScalingReport( const ScalingResult *pResults, int nNumResults )
+{
+    cout << endl;
+    cout << "Scaling Benchmark: " << getRenderModeName( g_nCurrentMode ) << ", precision "
+         << g_nPrecision << ", " << g_nBenchmarkFrames << " frames per thread" << endl;
+
+    for( int n = 0; n < nNumResults; ++n )
+    {
+        const ScalingResult *pResult = &pResults[n];
+
+        cout << pResult->nNumThreads << (pResult->nNumThreads == 1 ? " thread:  " : " threads: ")
+             << pResult->fFramesPerSecond << " FPS in all";
+
+        // Nothing to compare with if the single thread rendered nothing
+        if( pResults[0].fFramesPerSecond > 0.0f )
+            cout << ", " << pResult->fFramesPerSecond / pResults[0].fFramesPerSecond << "x one thread";
+
+        if( pResult->nNumFailed > 0 )
+            cout << ", " << pResult->nNumFailed << " without a context";
+
+        cout << endl;
+
+        for( int i = 0; i < pResult->nNumThreads; ++i )
+        {
+            cout << "    Thread " << i << " (ms): p50 " << pResult->afMedianFrameTime[i]
+                 << ", p95 " << pResult->afP95FrameTime[i] << ", p99 " << pResult->afP99FrameTime[i]
+                 << ", max " << pResult->afMaxFrameTime[i] << endl;
+        }
+    }
+
+    cout << endl;
+}
+
+//-----------------------------------------------------------------------------
+// Name: printScalingJSON()
+// Desc:
+//-----------------------------------------------------------------------------
+void printScalingJSON( const ScalingResult *pResults, int nNumResults )
+{
+    printf( "{\n" );
+    printf( "  \"mode\": \"%s\",\n", getRenderModeKey( g_nCurrentMode ) );
+    printf( "  \"precision\": %u,\n", g_nPrecision );
+    printf( "  \"layout\": \"%s\",\n", getLayoutKey( getSphereMeshLayout( g_nCurrentMode ) ) );
+    printf( "  \"spheres\": %d,\n", g_nNumSpheres );
+    printf( "  \"frames_per_thread\": %d,\n", g_nBenchmarkFrames );
+    printf( "  \"context\": \"%s\",\n", g_bHeadless ? "egl" : "glx" );
+    printf( "  \"runs\": [\n" );
+
+    for( int n = 0; n < nNumResults; ++n )
+    {
+        const ScalingResult *pResult = &pResults[n];
+
+        printf( "    {\n" );
+        printf( "      \"threads\": %d,\n", pResult->nNumThreads );
+        printf( "      \"failed_threads\": %d,\n", pResult->nNumFailed );
+        printf( "      \"elapsed_seconds\": %f,\n", pResult->fElapsed );
+        printf( "      \"frames_per_second\": %f,\n", pResult->fFramesPerSecond );
+
+        if( pResults[0].fFramesPerSecond > 0.0f )
+            printf( "      \"speedup\": %f,\n", pResult->fFramesPerSecond / pResults[0].fFramesPerSecond );
+        else
+            printf( "      \"speedup\": null,\n" );
+
+        printf( "      \"frame_time_ms\": [\n" );
+
+        for( int i = 0; i < pResult->nNumThreads; ++i )
+        {
+            printf( "        { \"p50\": %f, \"p95\": %f, \"p99\": %f, \"max\": %f }%s\n",
+                    pResult->afMedianFrameTime[i], pResult->afP95FrameTime[i],
+                    pResult->afP99FrameTime[i], pResult->afMaxFrameTime[i],
+                    i + 1 < pResult->nNumThreads ? "," : "" );
+        }
+
+        printf( "      ]\n" );
+        printf( "    }%s\n", n + 1 < nNumResults ? "," : "" );
+    }
+
+    printf( "  ]\n" );
+    printf( "}\n" );
+}
+
+//-----------------------------------------------------------------------------
+// Name: writeBenchmarkCSV()
+// Desc: One line per result, in the format compareWithBaseline() reads.
+//-----------------------------------------------------------------------------
+bool writeBenchmarkCSV( const char *pFileName, const BenchmarkResult *pResults, int nNumResults )
+{
+    FILE *pFile = fopen( pFileName, "w" );
+
+    if( pFile == NULL )
+    {
+        cerr << "ERROR: writeBenchmarkCSV - Couldn't open " << pFileName << "." << endl;
+        return false;
+    }
+
+    fprintf( pFile, "mode,precision,layout,vertex_format,triangles,frames,"
+                    "min_ms,p50_ms,p95_ms,p99_ms,max_ms,mean_ms,std_dev_ms,"
+                    "frames_per_second,triangles_per_second,spheres,scene,"
+                    "cpu_submit_p50_ms,swap_p50_ms,gpu_p50_ms\n" );
+
+    for( int k = 0; k < nNumResults; ++k )
+    {
+        const BenchmarkResult *pResult = &pResults[k];
+
+        fprintf( pFile, "%s,%u,%s,%s,%u,%d,%f,%f,%f,%f,%f,%f,%f,%f,%f,%d,%s,%f,%f,%f\n",
+                 getRenderModeKey( pResult->nMode ), pResult->nPrecision,
+                 getLayoutKey( pResult->nLayout ), getVertexFormatKey( pResult->nVertexFormat ),
+                 pResult->nNumTriangles, pResult->nFrames,
+                 pResult->fMinFrameTime, pResult->fMedianFrameTime, pResult->fP95FrameTime,
+                 pResult->fP99FrameTime, pResult->fMaxFrameTime, pResult->fMeanFrameTime,
+                 pResult->fStdDevFrameTime, pResult->fFramesPerSecond, 
+                 pResult->fTrianglesPerSecond, pResult->nNumSpheres,
+                 pResult->bInstanced ? "instanced" : "separate",
+                 pResult->fSubmitMedian, pResult->fSwapMedian, pResult->fGPUMedian );
+    }
+
+    fclose( pFile );
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: splitCSVLine()
+// Desc: Splits a line of a CSV file in place, at most nMaxFields fields, and
+//       returns how many there were. Quoting isn't supported.
+//-----------------------------------------------------------------------------
+int splitCSVLine( char *pLine, char **ppFields, int nMaxFields )
+{
+    int nNumFields = 0;
+
+    pLine[strcspn( pLine, "\r\n" )] = '\0';
+
+    while( nNumFields < nMaxFields )
+    {
+        ppFields[nNumFields++] = pLine;
+
+        char *pComma = strchr( pLine, ',' );
+
+        if( pComma == NULL )
+            break;
+
+        *pComma = '\0';
+        pLine   = pComma + 1;
+    }
+
+    return nNumFields;
+}
+
+//-----------------------------------------------------------------------------
+// Name: findCSVColumn()
+// Desc: Index of a column in the header fields, or -1.
+//-----------------------------------------------------------------------------
+int findCSVColumn( char **ppHeader, int nNumColumns, const char *pName )
+{
+    for( int i = 0; i < nNumColumns; ++i )
+    {
+        if( strcmp( ppHeader[i], pName ) == 0 )
+            return i;
+    }
+
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+// Name: compareWithBaseline()
+// Desc: Matches every result with the baseline line of the same mode, 
+//       precision, layout, vertex format and scene, and reports the ones 
+//       whose median frame time grew by more than g_fRegressionPercent. The 
+//       median is used since it's the least disturbed by the odd slow frame.
+//       Columns are found by name, and baselines written before the scene 
+//       columns existed are taken to be of a single sphere. Returns the 
+//       number of regressions, or -1 if the baseline can't be read.
+//-----------------------------------------------------------------------------
+int compareWithBaseline( const char *pFileName, const BenchmarkResult *pResults, int nNumResults )
+{
+    FILE *pFile = fopen( pFileName, "r" );
+
+    if( pFile == NULL )
+    {
+        cerr << "ERROR: compareWithBaseline - Couldn't open " << pFileName << "." << endl;
+        return -1;
+    }
+
+    char  header[1024];
+    char *apHeader[MAX_CSV_COLUMNS];
+    int   nNumColumns = 0;
+
+    if( fgets( header, sizeof(header), pFile ) != NULL )
+        nNumColumns = splitCSVLine( header, apHeader, MAX_CSV_COLUMNS );
+
+    int nModeColumn      = findCSVColumn( apHeader, nNumColumns, "mode" );
+    int nPrecisionColumn = findCSVColumn( apHeader, nNumColumns, "precision" );
+    int nLayoutColumn    = findCSVColumn( apHeader, nNumColumns, "layout" );
+    int nFormatColumn    = findCSVColumn( apHeader, nNumColumns, "vertex_format" );
+    int nMedianColumn    = findCSVColumn( apHeader, nNumColumns, "p50_ms" );
+    int nSpheresColumn   = findCSVColumn( apHeader, nNumColumns, "spheres" );
+    int nSceneColumn     = findCSVColumn( apHeader, nNumColumns, "scene" );
+
+    if( nModeColumn < 0 || nPrecisionColumn < 0 || nLayoutColumn < 0 || 
+        nFormatColumn < 0 || nMedianColumn < 0 )
+    {
+        cerr << "ERROR: compareWithBaseline - " << pFileName << " isn't a benchmark CSV file." << endl;
+        fclose( pFile );
+        return -1;
+    }
+
+    bool *pbMatched       = new bool[nNumResults];
+    int   nNumRegressions = 0;
+    char  line[1024];
+    char *apFields[MAX_CSV_COLUMNS];
+
+    for( int k = 0; k < nNumResults; ++k )
+        pbMatched[k] = false;
+
+    while( fgets( line, sizeof(line), pFile ) != NULL )
+    {
+        if( splitCSVLine( line, apFields, MAX_CSV_COLUMNS ) != nNumColumns )
+            continue;
+
+        const char *pMode            = apFields[nModeColumn];
+        GLuint      nPrecision       = (GLuint)atoi( apFields[nPrecisionColumn] );
+        float       fMedianFrameTime = (float)atof( apFields[nMedianColumn] );
+        int         nNumSpheres      = (nSpheresColumn < 0) ? 1 : atoi( apFields[nSpheresColumn] );
+        bool        bInstanced       = (nSceneColumn >= 0) && strcmp( apFields[nSceneColumn], "instanced" ) == 0;
+
+        for( int k = 0; k < nNumResults; ++k )
+        {
+            const BenchmarkResult *pResult = &pResults[k];
+
+            if( pResult->nPrecision  != nPrecision  ||
+                pResult->nNumSpheres != nNumSpheres ||
+                pResult->bInstanced  != bInstanced  ||
+                strcmp( pMode, getRenderModeKey( pResult->nMode ) )                            != 0 ||
+                strcmp( apFields[nLayoutColumn], getLayoutKey( pResult->nLayout ) )             != 0 ||
+                strcmp( apFields[nFormatColumn], getVertexFormatKey( pResult->nVertexFormat ) ) != 0 )
+                continue;
+
+            pbMatched[k] = true;
+
+            float fChange = (pResult->fMedianFrameTime / fMedianFrameTime - 1.0f) * 100.0f;
+
+            if( fChange > g_fRegressionPercent )
+            {
+                cerr << "REGRESSION: " << pMode << " at precision " << nPrecision 
+                     << ": median frame " << pResult->fMedianFrameTime << " ms against " 
+                     << fMedianFrameTime << " ms (+" << fChange << "%)" << endl;
+
+                ++nNumRegressions;
+            }
+        }
+    }
+
+    fclose( pFile );
+
+    for( int k = 0; k < nNumResults; ++k )
+    {
+        if( !pbMatched[k] )
+            cerr << "WARNING: compareWithBaseline - No baseline for " 
+                 << getRenderModeKey( pResults[k].nMode ) << " at precision " 
+                 << pResults[k].nPrecision << "." << endl;
+    }
+
+    delete []pbMatched;
+
+    cerr << "Baseline: " << nNumRegressions << " of " << nNumResults 
+         << " results regressed by more than " << g_fRegressionPercent << "%." << endl;
+
+    return nNumRegressions;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getBitmapImageData()
+// Desc: Simply image loader for 24 bit BMP files.
+//-----------------------------------------------------------------------------
+void getBitmapImageData( char *pFileName, BMPImage *pImage )
+{
+    FILE *pFile = NULL;
+    unsigned short nNumPlanes;
+    unsigned short nNumBPP;
+	int i;
+
+    if( (pFile = fopen(pFileName, "rb") ) == NULL )
+		cout << "ERROR: getBitmapImageData - %s not found " << pFileName << "." << endl;
+
+    // Seek forward to width and height info
+    fseek( pFile, 18, SEEK_CUR );
+
+    if( (i = fread(&pImage->width, 4, 1, pFile) ) != 1 )
+		cout << "ERROR: getBitmapImageData - Couldn't read width from " << pFileName << "." << endl; 
+
+    if( (i = fread(&pImage->height, 4, 1, pFile) ) != 1 )
+		cout << "ERROR: getBitmapImageData - Couldn't read height from " << pFileName << "." << endl; 
+
+    if( (fread(&nNumPlanes, 2, 1, pFile) ) != 1 )
+		cout << "ERROR: getBitmapImageData - Couldn't read plane count from " << pFileName << "." << endl; 
+	
+    if( nNumPlanes != 1 )
+		cout << "ERROR: getBitmapImageData - Plane count from " << pFileName << " is not 1: " << nNumPlanes << "." << endl;
+
+    if( (i = fread(&nNumBPP, 2, 1, pFile)) != 1 )
+		cout << "ERROR: getBitmapImageData - Couldn't read BPP from " << pFileName << endl; 
+	
+    if( nNumBPP != 24 )
+		cout << "ERROR: getBitmapImageData - BPP from " << pFileName << " is not 24: " << nNumBPP << "." << endl;
+
+    // Seek forward to image data
+    fseek( pFile, 24, SEEK_CUR );
+
+	// Calculate the image's total size in bytes. Note how we multiply the 
+	// result of (width * height) by 3. This is becuase a 24 bit color BMP 
+	// file will give you 3 bytes per pixel.
+    int nTotalImagesize = (pImage->width * pImage->height) * 3;
+
+    pImage->data = (char*) malloc( nTotalImagesize );
+	
+    if( (i = fread(pImage->data, nTotalImagesize, 1, pFile) ) != 1 )
+		cout << "ERROR: getBitmapImageData - Couldn't read image data from " << pFileName << "." << endl;
+
+    //
+	// Finally, rearrange BGR to RGB
+	//
+	
+	char charTemp;
+    for( i = 0; i < nTotalImagesize; i += 3 )
+	{ 
+		charTemp = pImage->data[i];
+		pImage->data[i] = pImage->data[i+2];
+		pImage->data[i+2] = charTemp;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: loadTexture()
+// Desc: Loads mars.bmp, resampled to g_nTextureSize texels square if asked,
+//       uploads it a strip of rows at a time through pixel buffers (or in
+//       one glTexImage2D with --direct-upload) and builds its mipmaps.
+//       Both steps are timed to the glFinish(), for the benchmark report.
+//-----------------------------------------------------------------------------
+void loadTexture( void )
+{
+	BMPImage textureImage;
+
+    getBitmapImageData( "mars.bmp", &textureImage );
+
+    if( g_nTextureSize > 0 )
+    {
+        GLint nMaxSize = 0;
+        glGetIntegerv( GL_MAX_TEXTURE_SIZE, &nMaxSize );
+
+        if( g_nTextureSize > nMaxSize )
+        {
+            cerr << "ERROR: loadTexture - " << g_nTextureSize << " texels is over the "
+                 << nMaxSize << " texel limit, using that instead." << endl;
+            g_nTextureSize = nMaxSize;
+        }
+
+        resampleTexture( &textureImage, g_nTextureSize );
+    }
+
+    g_nTextureWidth  = textureImage.width;
+    g_nTextureHeight = textureImage.height;
+
+	glGenTextures( 1, &g_textureID );
+	glBindTexture( GL_TEXTURE_2D, g_textureID );
+
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+    setTextureFilter();
+
+    // Resampled rows needn't be a multiple of 4 bytes long
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+    uint64_t nStart = getTimeNanoseconds();
+
+    if( g_bDirectTextureUpload )
+    {
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB8, textureImage.width, textureImage.height,
+                      0, GL_RGB, GL_UNSIGNED_BYTE, textureImage.data );
+        g_nTextureStrips = 1;
+    }
+    else
+    {
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB8, textureImage.width, textureImage.height,
+                      0, GL_RGB, GL_UNSIGNED_BYTE, NULL );
+        g_nTextureStrips = uploadTextureStrips( (const GLubyte *)textureImage.data,
+                                                textureImage.width, textureImage.height );
+    }
+
+    glFinish();
+
+    uint64_t nUploaded = getTimeNanoseconds();
+
+    glGenerateMipmap( GL_TEXTURE_2D );
+    glFinish();
+
+    g_fTextureUploadTime = (nUploaded - nStart) / 1000000.0f;
+    g_fMipmapTime        = (getTimeNanoseconds() - nUploaded) / 1000000.0f;
+
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+    free( textureImage.data );
+
+    if( !g_bHeadless )
+        cout << "Texture: " << g_nTextureWidth << "x" << g_nTextureHeight << ", uploaded in "
+             << g_fTextureUploadTime << " ms (" << g_nTextureStrips << " strips), mipmaps in "
+             << g_fMipmapTime << " ms" << endl;
+}
+
+//-----------------------------------------------------------------------------
+// Name: uploadTextureStrips()
+// Desc: Copies the image into the bound texture's base level through a ring
+//       of pixel unpack buffers, TEXTURE_STRIP_BYTES at a time, so filling
+//       one buffer overlaps the driver pulling the last one into the
+//       texture, and the driver never has to take the whole image at once.
+//       Returns how many strips it took.
+//-----------------------------------------------------------------------------
+int uploadTextureStrips( const GLubyte *pData, int nWidth, int nHeight )
+{
+    GLuint pbos[NUM_TEXTURE_UPLOAD_BUFFERS];
+    size_t nRowBytes   = (size_t)nWidth * 3;
+    int    nStripRows  = max( (int)(TEXTURE_STRIP_BYTES / nRowBytes), 1 );
+    int    nNumStrips  = 0;
+
+    glGenBuffers( NUM_TEXTURE_UPLOAD_BUFFERS, pbos );
+
+    for( int y = 0; y < nHeight; y += nStripRows, ++nNumStrips )
+    {
+        int    nRows  = min( nStripRows, nHeight - y );
+        size_t nBytes = nRows * nRowBytes;
+
+        glBindBuffer( GL_PIXEL_UNPACK_BUFFER, pbos[nNumStrips % NUM_TEXTURE_UPLOAD_BUFFERS] );
+
+        // Orphaning the buffer lets the driver keep the old storage until
+        // it's done reading the strip before last out of it
+        glBufferData( GL_PIXEL_UNPACK_BUFFER, nBytes, NULL, GL_STREAM_DRAW );
+
+        void *pStrip = glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, nBytes,
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT );
+
+        if( pStrip == NULL )
+        {
+            cerr << "ERROR: uploadTextureStrips - glMapBufferRange failed." << endl;
+
+            glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+            glTexSubImage2D( GL_TEXTURE_2D, 0, 0, y, nWidth, nHeight - y, GL_RGB,
+                             GL_UNSIGNED_BYTE, pData + y * nRowBytes );
+            ++nNumStrips;
+            break;
+        }
+
+        memcpy( pStrip, pData + y * nRowBytes, nBytes );
+        glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER );
+
+        glTexSubImage2D( GL_TEXTURE_2D, 0, 0, y, nWidth, nRows, GL_RGB, GL_UNSIGNED_BYTE, NULL );
+    }
+
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+    glDeleteBuffers( NUM_TEXTURE_UPLOAD_BUFFERS, pbos );
+
+    return nNumStrips;
+}
+
+//-----------------------------------------------------------------------------
+// Name: setTextureFilter()
+// Desc: Minifies the sphere texture from its mipmaps, or from the base level
+//       alone with g_bMipmaps off, as it was before there were mipmaps.
+//-----------------------------------------------------------------------------
+void setTextureFilter( void )
+{
+    glBindTexture( GL_TEXTURE_2D, g_textureID );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                     g_bMipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+}
+
+// The bitmap resampleTexture() hands the threads of the pool, and the
+// image they fill in from it
+struct TextureResampleJob
+{
+    const GLubyte *pSource;
+    int            nSourceWidth;
+    int            nSourceHeight;
+    GLubyte       *pDest;
+    int            nSize;
+};
+
+//-----------------------------------------------------------------------------
+// Name: resampleTexture()
+// Desc: Stretches the image to nSize texels square, across the generation
+//       threads, to stand in for a large texture. The bitmap is all there is
+//       to go on, so this adds texels but no detail.
+//-----------------------------------------------------------------------------
+void resampleTexture( BMPImage *pImage, int nSize )
+{
+    TextureResampleJob job;
+
+    job.pSource       = (const GLubyte *)pImage->data;
+    job.nSourceWidth  = pImage->width;
+    job.nSourceHeight = pImage->height;
+    job.pDest         = (GLubyte *)malloc( (size_t)nSize * nSize * 3 );
+    job.nSize         = nSize;
+
+    if( job.pDest == NULL )
+    {
+        cerr << "ERROR: resampleTexture - Couldn't allocate a " << nSize << "x" << nSize
+             << " texture, keeping the bitmap's size." << endl;
+        return;
+    }
+
+    runThreadPoolJob( resampleTextureRows, &job, nSize, g_nGenerationThreads );
+
+    free( pImage->data );
+
+    pImage->data   = (char *)job.pDest;
+    pImage->width  = nSize;
+    pImage->height = nSize;
+}
+
+//-----------------------------------------------------------------------------
+// Name: resampleTextureRows()
+// Desc: Thread pool job for resampleTexture(), one row per item. Filters
+//       bilinearly between texel centres, wrapping around in u like the
+//       sphere does and clamping at the poles in v.
+//-----------------------------------------------------------------------------
+void resampleTextureRows( void *pData, int nFirst, int nLast )
+{
+    TextureResampleJob *pJob = (TextureResampleJob *)pData;
+    int                 w    = pJob->nSourceWidth;
+    int                 h    = pJob->nSourceHeight;
+
+    for( int y = nFirst; y < nLast; ++y )
+    {
+        float fv = (y + 0.5f) * h / pJob->nSize - 0.5f;
+        int   v0 = max( min( (int)floorf( fv ), h - 1 ), 0 );
+        int   v1 = min( v0 + 1, h - 1 );
+        float tv = max( min( fv - v0, 1.0f ), 0.0f );
+
+        const GLubyte *pRow0 = pJob->pSource + (size_t)v0 * w * 3;
+        const GLubyte *pRow1 = pJob->pSource + (size_t)v1 * w * 3;
+        GLubyte       *pDest = pJob->pDest + (size_t)y * pJob->nSize * 3;
+
+        for( int x = 0; x < pJob->nSize; ++x )
+        {
+            float fu = (x + 0.5f) * w / pJob->nSize - 0.5f;
+            int   u0 = (int)floorf( fu );
+            float tu = fu - u0;
+
+            u0 = (u0 + w) % w;
+
+            int u1 = (u0 + 1) % w;
+
+            for( int c = 0; c < 3; ++c )
+            {
+                float fTop    = pRow0[u0*3 + c] + tu * (pRow0[u1*3 + c] - pRow0[u0*3 + c]);
+                float fBottom = pRow1[u0*3 + c] + tu * (pRow1[u1*3 + c] - pRow1[u0*3 + c]);
+
+                pDest[x*3 + c] = (GLubyte)(fTop + tv * (fBottom - fTop) + 0.5f);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: renderSphere()
+// Desc: Create a sphere centered at cy, cx, cz with radius r, and 
+//       precision p. Based on a function Written by Paul Bourke. 
+//       http://astronomy.swin.edu.au/~pbourke/opengl/sphere/
+//-----------------------------------------------------------------------------
+void renderSphere( float cx, float cy, float cz, float r, int p )
+{
+    // Disallow a negative number for radius.
+    if( r < 0 )
+        r = -r;
+
+    // Disallow a negative number for precision.
+    if( p < 0 )
+        p = -p;
+
+    // If the sphere is too small, just render a OpenGL point instead.
+    if( p < 4 || r <= 0 ) 
+    {
+        glBegin( GL_POINTS );
+        glVertex3f( cx, cy, cz );
+        glEnd();
+        return;
+    }
+
+    // Every sinf/cosf the strips need is taken once, up front
+    SphereTables tables;
+    createSphereTables( &tables, cx, cy, cz, r, p );
+
+    float v[SPHERE_VERTEX_FLOATS];
+
+    for( int i = 0; i < p/2; ++i )
+    {
+        glBegin( GL_TRIANGLE_STRIP );
+        {
+            for( int j = 0; j <= p; ++j )
+            {
+                getSphereVertex( &tables, i + 1, j, v );
+
+                glNormal3f( v[2], v[3], v[4] );
+                glTexCoord2f( v[0], v[1] );
+                glVertex3f( v[5], v[6], v[7] );
+
+                getSphereVertex( &tables, i, j, v );
+
+                glNormal3f( v[2], v[3], v[4] );
+                glTexCoord2f( v[0], v[1] );
+                glVertex3f( v[5], v[6], v[7] );
+            }
+        }
+        glEnd();
+    }
+
+    destroySphereTables( &tables );
+}
+
+//-----------------------------------------------------------------------------
+// Name: createSphereDisplayList()
+// Desc: Build Sphere Display List
+//-----------------------------------------------------------------------------
+void createSphereDisplayList()
+{
+    // Every cached sphere has a list of its own
+    if( g_sphereDList == 0 )
+        g_sphereDList = glGenLists(1);
+
+    // The list caches the same strips the vertex array would hold
+    int p = g_nMeshPrecision;
+
+    g_nNumSphereVertices = (p/2) * ((p+1)*2);
+
+    if( g_sphereDList != 0 )
+    {
+        glNewList( g_sphereDList, GL_COMPILE );
+
+        // Cache the calls needed to render a sphere. When the builder thread
+        // has already made the strips, they're copied out of the array one
+        // band at a time instead of being generated again.
+        if( g_pSphereVertices != NULL )
+        {
+            glInterleavedArrays( GL_T2F_N3F_V3F, 0, g_pSphereVertices );
+
+            for( int i = 0; i < p/2; ++i )
+                glDrawArrays( GL_TRIANGLE_STRIP, i * ((p+1)*2), (p+1)*2 );
+        }
+        else
+            renderSphere( 0.0f, 0.0f, 0.0f, g_fMeshRadius, p );
+
+        glEndList();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: createSphereBuffer()
+// Desc: Uploads the sphere's vertex array once into a static Vertex Buffer
+//       Object, so drawing it no longer sends every vertex across to the 
+//       driver each frame. The array must already have been created.
+//-----------------------------------------------------------------------------
+void createSphereBuffer()
+{
+    if( g_nPackedFormat != g_nVertexFormat )
+        packSphereVertices();
+
+    if( g_sphereVBO == 0 )
+        glGenBuffers( 1, &g_sphereVBO );
+
+    glBindBuffer( GL_ARRAY_BUFFER, g_sphereVBO );
+    glBufferData( GL_ARRAY_BUFFER, (GLsizeiptr)g_nNumSphereVertices * getVertexFormatSize( g_nVertexFormat ), 
+                  getSphereVertexData(), GL_STATIC_DRAW );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    if( g_nSphereLayout != STRIP_LAYOUT )
+    {
+        if( g_sphereIBO == 0 )
+            glGenBuffers( 1, &g_sphereIBO );
+
+        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, g_sphereIBO );
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)g_nNumSphereIndices * getIndexSize(), 
+                      g_pSphereIndices, GL_STATIC_DRAW );
+        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+    }
+
+    g_nBufferFormat = g_nVertexFormat;
+}
+
+//-----------------------------------------------------------------------------
+// Name: floatToHalf()
+// Desc: Converts to an IEEE half-float, rounding to nearest.
+//-----------------------------------------------------------------------------
+GLhalf floatToHalf( float f )
+{
+    union { float f; GLuint u; } bits;
+    bits.f = f;
+
+    GLuint nSign     = (bits.u >> 16) & 0x8000;
+    int    nExponent = (int)((bits.u >> 23) & 0xff) - 127 + 15;
+    GLuint nMantissa = bits.u & 0x007fffff;
+
+    // Too small even for a denormal
+    if( nExponent < -10 )
+        return (GLhalf)nSign;
+
+    // Denormal, shift the implicit leading one into the mantissa
+    if( nExponent <= 0 )
+    {
+        nMantissa |= 0x00800000;
+        GLuint nShift = 14 - nExponent;
+        return (GLhalf)(nSign | ((nMantissa + (1 << (nShift - 1))) >> nShift));
+    }
+
+    // Overflows, and infinities or NaNs
+    if( nExponent >= 31 )
+        return (GLhalf)(nSign | 0x7c00 | ((bits.u & 0x7fffffff) > 0x7f800000 ? 0x200 : 0));
+
+    // A carry out of the rounded mantissa correctly bumps the exponent
+    return (GLhalf)(nSign | (((nExponent << 10) | (nMantissa >> 13)) + ((nMantissa >> 12) & 1)));
+}
+
+//-----------------------------------------------------------------------------
+// Name: packSnorm8()
+// Desc: Packs a value in [-1, 1] as a normalized signed byte.
+//-----------------------------------------------------------------------------
+GLbyte packSnorm8( float f )
+{
+    return (GLbyte)floorf( f * 127.0f + 0.5f );
+}
+
+//-----------------------------------------------------------------------------
+// Name: getVertexFormatSize()
+// Desc: Bytes per vertex of a vertex format.
+//-----------------------------------------------------------------------------
+GLuint getVertexFormatSize( GLuint nFormat )
+{
+    switch( nFormat )
+    {
+        case HALF_FORMAT:  return sizeof(HalfVertex);
+        case SHORT_FORMAT: return sizeof(ShortVertex);
+    }
+
+    return sizeof(Vertex);
+}
+
+//-----------------------------------------------------------------------------
+// Name: getSphereVertexData()
+// Desc: The sphere's vertices in the current vertex format.
+//-----------------------------------------------------------------------------
+const GLvoid *getSphereVertexData( void )
+{
+    if( g_nVertexFormat == FLOAT_FORMAT )
+        return g_pSphereVertices;
+
+    return g_pPackedVertices;
+}
+
+//-----------------------------------------------------------------------------
+// Name: packSphereVertices()
+// Desc: Builds the compact copy of g_pSphereVertices for the current vertex 
+//       format.
+//-----------------------------------------------------------------------------
+void packSphereVertices( void )
+{
+    SphereMesh mesh;
+    mesh.pVertices            = g_pSphereVertices;
+    mesh.nNumVertices         = g_nNumSphereVertices;
+    mesh.pPackedVertices      = g_pPackedVertices;
+    mesh.fPackedPositionScale = g_fPackedPositionScale;
+
+    packSphereMesh( &mesh, g_nVertexFormat );
+
+    g_pPackedVertices      = mesh.pPackedVertices;
+    g_nPackedFormat        = mesh.nPackedFormat;
+    g_fPackedPositionScale = mesh.fPackedPositionScale;
+}
+
+//-----------------------------------------------------------------------------
+// Name: packSphereMesh()
+// Desc: Builds the compact copy of a sphere's vertices in nFormat. Texture 
+//       coordinates are stored as 1 - j/p instead of -j/p in the short 
+//       format, which samples the same texels with GL_REPEAT.
+//-----------------------------------------------------------------------------
+void packSphereMesh( SphereMesh *pMesh, GLuint nFormat )
+{
+    if( pMesh->pPackedVertices != NULL )
+    {
+        free( pMesh->pPackedVertices );
+        pMesh->pPackedVertices = NULL;
+    }
+
+    pMesh->nPackedFormat = nFormat;
+
+    if( nFormat == FLOAT_FORMAT )
+        return;
+
+    pMesh->pPackedVertices = malloc( (size_t)pMesh->nNumVertices * getVertexFormatSize( nFormat ) );
+
+    if( nFormat == HALF_FORMAT )
+    {
+        HalfVertex *pVertices = (HalfVertex *)pMesh->pPackedVertices;
+
+        for( GLuint i = 0; i < pMesh->nNumVertices; ++i )
+        {
+            Vertex *pVertex = pMesh->pVertices + i;
+
+            pVertices[i].tu  = floatToHalf( pVertex->tu );
+            pVertices[i].tv  = floatToHalf( pVertex->tv );
+            pVertices[i].nx  = packSnorm8( pVertex->nx );
+            pVertices[i].ny  = packSnorm8( pVertex->ny );
+            pVertices[i].nz  = packSnorm8( pVertex->nz );
+            pVertices[i].pad = 0;
+            pVertices[i].vx  = pVertex->vx;
+            pVertices[i].vy  = pVertex->vy;
+            pVertices[i].vz  = pVertex->vz;
+        }
+    }
+
+    if( nFormat == SHORT_FORMAT )
+    {
+        ShortVertex *pVertices = (ShortVertex *)pMesh->pPackedVertices;
+
+        // Positions are stored relative to the largest coordinate, which is
+        // the radius for a sphere centered at the origin.
+        float fMaxCoord = 0.0f;
+
+        for( GLuint i = 0; i < pMesh->nNumVertices; ++i )
+        {
+            Vertex *pVertex = pMesh->pVertices + i;
+
+            fMaxCoord = max( fMaxCoord, fabsf( pVertex->vx ) );
+            fMaxCoord = max( fMaxCoord, fabsf( pVertex->vy ) );
+            fMaxCoord = max( fMaxCoord, fabsf( pVertex->vz ) );
+        }
+
+        if( fMaxCoord == 0.0f )
+            fMaxCoord = 1.0f;
+
+        pMesh->fPackedPositionScale = fMaxCoord / 32767.0f;
+
+        for( GLuint i = 0; i < pMesh->nNumVertices; ++i )
+        {
+            Vertex *pVertex = pMesh->pVertices + i;
+
+            // Every tu is in (-2, 0], so a whole turn of the texture brings
+            // them all into range. Shifting only the negative ones would
+            // tear the first column of each band away from its neighbours.
+            float   tu      = pVertex->tu + 1.0f;
+
+            pVertices[i].tu   = (GLshort)floorf( tu * 32767.0f + 0.5f );
+            pVertices[i].tv   = (GLshort)floorf( pVertex->tv * 32767.0f + 0.5f );
+            pVertices[i].nx   = packSnorm8( pVertex->nx );
+            pVertices[i].ny   = packSnorm8( pVertex->ny );
+            pVertices[i].nz   = packSnorm8( pVertex->nz );
+            pVertices[i].pad  = 0;
+            pVertices[i].vx   = (GLshort)floorf( pVertex->vx / pMesh->fPackedPositionScale + 0.5f );
+            pVertices[i].vy   = (GLshort)floorf( pVertex->vy / pMesh->fPackedPositionScale + 0.5f );
+            pVertices[i].vz   = (GLshort)floorf( pVertex->vz / pMesh->fPackedPositionScale + 0.5f );
+            pVertices[i].pad2 = 0;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: beginSphereArrays()
+// Desc: Points the texture coordinate, normal and vertex arrays at the 
+//       sphere's vertices in the current format. pBase is either a client 
+//       address or an offset into the bound buffer object.
+//-----------------------------------------------------------------------------
+void beginSphereArrays( const GLubyte *pBase )
+{
+    if( g_nVertexFormat == FLOAT_FORMAT )
+    {
+        glInterleavedArrays( GL_T2F_N3F_V3F, 0, pBase );
+        return;
+    }
+
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+    glEnableClientState( GL_VERTEX_ARRAY );
+
+    if( g_nVertexFormat == HALF_FORMAT )
+    {
+        GLsizei nStride = sizeof(HalfVertex);
+
+        glTexCoordPointer( 2, GL_HALF_FLOAT, nStride, pBase + offsetof(HalfVertex, tu) );
+        glNormalPointer( GL_BYTE, nStride, pBase + offsetof(HalfVertex, nx) );
+        glVertexPointer( 3, GL_FLOAT, nStride, pBase + offsetof(HalfVertex, vx) );
+    }
+
+    if( g_nVertexFormat == SHORT_FORMAT )
+    {
+        GLsizei nStride = sizeof(ShortVertex);
+
+        glTexCoordPointer( 2, GL_SHORT, nStride, pBase + offsetof(ShortVertex, tu) );
+        glNormalPointer( GL_BYTE, nStride, pBase + offsetof(ShortVertex, nx) );
+        glVertexPointer( 3, GL_SHORT, nStride, pBase + offsetof(ShortVertex, vx) );
+
+        // Fixed-function arrays don't normalize integer texture coordinates
+        // and positions, so scale them back with the matrices instead.
+        glMatrixMode( GL_TEXTURE );
+        glPushMatrix();
+        glScalef( 1.0f / 32767.0f, 1.0f / 32767.0f, 1.0f );
+
+        glMatrixMode( GL_MODELVIEW );
+        glPushMatrix();
+        glScalef( g_fPackedPositionScale, g_fPackedPositionScale, g_fPackedPositionScale );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: endSphereArrays()
+// Desc: Undoes what beginSphereArrays() did to the matrices.
+//-----------------------------------------------------------------------------
+void endSphereArrays( void )
+{
+    if( g_nVertexFormat == SHORT_FORMAT )
+    {
+        glMatrixMode( GL_TEXTURE );
+        glPopMatrix();
+
+        glMatrixMode( GL_MODELVIEW );
+        glPopMatrix();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: createSphereGeometry()
+// Desc: Creates a sphere as an array of vertex data suitable to be fed into a 
+//       OpenGL vertex array. The sphere will be centered at cy, cx, cz with 
+//       radius r, and precision p. Based on a function Written by Paul Bourke. 
+//       http://astronomy.swin.edu.au/~pbourke/opengl/sphere/
+//-----------------------------------------------------------------------------
+void createSphereGeometry( float cx, float cy, float cz, float r, int p )	
+{
+    SphereMesh mesh;
+    loadSphereMesh( &mesh, cx, cy, cz, r, p, g_nSphereLayout );
+    setSphereArrays( &mesh );
+}
+
+//-----------------------------------------------------------------------------
+// Name: setSphereArrays()
+// Desc: Replaces the current sphere's client arrays with the ones of pMesh,
+//       as made by generateSphereMesh() and packSphereMesh().
+//-----------------------------------------------------------------------------
+void setSphereArrays( const SphereMesh *pMesh )
+{
+    if( g_pMeshFile != NULL )
+        unmapMeshFile( g_pMeshFile, g_nMeshFileBytes );
+    else
+    {
+        delete []g_pSphereVertices;
+        free( g_pSphereIndices );
+    }
+
+    free( g_pPackedVertices );
+
+    g_pMeshFile            = pMesh->pMeshFile;
+    g_nMeshFileBytes       = pMesh->nMeshFileBytes;
+    g_pSphereVertices      = pMesh->pVertices;
+    g_nNumSphereVertices   = pMesh->nNumVertices;
+    g_pPackedVertices      = pMesh->pPackedVertices;
+    g_nPackedFormat        = pMesh->nPackedFormat;
+    g_fPackedPositionScale = pMesh->fPackedPositionScale;
+    g_pSphereIndices       = pMesh->pIndices;
+    g_sphereIndexType      = pMesh->indexType;
+    g_sphereIndexPrimitive = pMesh->indexPrimitive;
+    g_nNumSphereIndices    = pMesh->nNumIndices;
+    g_fSphereACMR          = pMesh->fACMR;
+    g_fSphereATVR          = pMesh->fATVR;
+}
+
+//-----------------------------------------------------------------------------
+// Name: generateSphereMesh()
+// Desc: Creates the client arrays of a sphere in a layout. Only pMesh is 
+//       written to, never the current sphere, so this can run on any thread.
+//-----------------------------------------------------------------------------
+void generateSphereMesh( SphereMesh *pMesh, float cx, float cy, float cz, float r, int p,
+                         GLuint nLayout )
+{
+    pMesh->pPackedVertices      = NULL;
+    pMesh->nPackedFormat        = FLOAT_FORMAT;
+    pMesh->fPackedPositionScale = 1.0f;
+    pMesh->pMeshFile            = NULL;
+    pMesh->nMeshFileBytes       = 0;
+
+    if( nLayout == ICOSPHERE_LAYOUT )
+    {
+        generateIcosphereMesh( pMesh, cx, cy, cz, r, p );
+        return;
+    }
+
+    if( nLayout != STRIP_LAYOUT )
+    {
+        generateIndexedSphereMesh( pMesh, cx, cy, cz, r, p, nLayout );
+        return;
+    }
+
+    // The strip layout draws straight from the vertex array
+    pMesh->pIndices       = NULL;
+    pMesh->indexType      = GL_UNSIGNED_SHORT;
+    pMesh->indexPrimitive = GL_TRIANGLE_STRIP;
+    pMesh->nNumIndices    = 0;
+
+    //-------------------------------------------------------------------------
+    // If sphere precision is set to 4, then 20 verts will be needed to 
+    // hold the array of GL_TRIANGLE_STRIP(s) and so on...
+    //
+    // Example:
+    //
+    // total_verts = (p/2) * ((p+1)*2)
+    // total_verts = (4/2) * (  5  *2)
+    // total_verts =   2   *  10
+    // total_verts =      20
+    //-------------------------------------------------------------------------
+
+    pMesh->nNumVertices = (p/2) * ((p+1)*2);
+    pMesh->pVertices    = new Vertex[pMesh->nNumVertices];
+
+    // Disallow a negative number for radius.
+    if( r < 0 )
+        r = -r;
+
+    // Disallow a negative number for precision.
+    if( p < 4 ) 
+        p = 4;
+
+    generateSphereVertices( pMesh->pVertices, cx, cy, cz, r, p, 
+                            STRIP_LAYOUT, g_nGenerationThreads );
+
+    // Without indices nothing can be reused, so every vertex is transformed
+    pMesh->fACMR = pMesh->nNumVertices / (float)(pMesh->nNumVertices - 2);
+    pMesh->fATVR = 1.0f;
+}
+
+//-----------------------------------------------------------------------------
+// Name: loadSphereMesh()
+// Desc: Like generateSphereMesh(), but maps the sphere from its mesh file
+//       when there is one, and saves the ones that were slow to generate
+//       for next time. Only pMesh is written to, so this can run on any
+//       thread too.
+//-----------------------------------------------------------------------------
+void loadSphereMesh( SphereMesh *pMesh, float cx, float cy, float cz, float r, int p,
+                     GLuint nLayout )
+{
+    // The files only hold spheres around the origin, which is all that's
+    // ever drawn from a mesh
+    bool bUseFile = g_pMeshFileDir[0] != '\0' && cx == 0.0f && cy == 0.0f && cz == 0.0f;
+    char szFileName[1024];
+
+    if( bUseFile )
+    {
+        getMeshFileName( szFileName, sizeof(szFileName), r, p, nLayout );
+
+        if( mapSphereMesh( pMesh, szFileName, r, p, nLayout ) )
+        {
+            __sync_fetch_and_add( &g_nMeshFilesLoaded, 1 );
+            return;
+        }
+    }
+
+    uint64_t nStart = getTimeNanoseconds();
+
+    generateSphereMesh( pMesh, cx, cy, cz, r, p, nLayout );
+
+    float fTime = (getTimeNanoseconds() - nStart) / 1000000.0f;
+
+    if( bUseFile && fTime >= MESH_FILE_MIN_BUILD_MS && 
+        saveSphereMesh( pMesh, szFileName, r, p, nLayout ) )
+    {
+        __sync_fetch_and_add( &g_nMeshFilesWritten, 1 );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: getMeshFileName()
+// Desc:
+//-----------------------------------------------------------------------------
+void getMeshFileName( char *pFileName, size_t nSize, float r, int p, GLuint nLayout )
+{
+    snprintf( pFileName, nSize, "%s/%s_%d_r%g.mesh", g_pMeshFileDir,
+              getLayoutKey( nLayout ), p, r );
+}
+
+//-----------------------------------------------------------------------------
+// Name: mapSphereMesh()
+// Desc: Points pMesh's client arrays into the mapped mesh file. Fails if
+//       there's no file, or it holds a different sphere or was made with
+//       another vertex cache size, in which case it's generated again.
+//-----------------------------------------------------------------------------
+bool mapSphereMesh( SphereMesh *pMesh, const char *pFileName, float r, int p, GLuint nLayout )
+{
+    MeshFileHeader header;
+    size_t         nBytes;
+    GLubyte       *pFile = (GLubyte *)mapMeshFile( pFileName, &header, &nBytes );
+
+    if( pFile == NULL )
+        return false;
+
+    if( header.nLayout != nLayout || header.nPrecision != (uint32_t)p || header.fRadius != r ||
+        header.nVertexSize != sizeof(Vertex) || header.nCacheSize != (uint32_t)g_nVertexCacheSize ||
+        (header.nIndexSize != sizeof(GLushort) && header.nIndexSize != sizeof(GLuint)) )
+    {
+        unmapMeshFile( pFile, nBytes );
+        return false;
+    }
+
+    pMesh->pVertices            = (Vertex *)(pFile + header.nVertexOffset);
+    pMesh->nNumVertices         = header.nNumVertices;
+    pMesh->pPackedVertices      = NULL;
+    pMesh->nPackedFormat        = FLOAT_FORMAT;
+    pMesh->fPackedPositionScale = 1.0f;
+    pMesh->pIndices             = (header.nNumIndices > 0) ? pFile + header.nIndexOffset : NULL;
+    pMesh->indexType            = (header.nIndexSize == sizeof(GLushort)) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    pMesh->indexPrimitive       = header.nIndexPrimitive;
+    pMesh->nNumIndices          = header.nNumIndices;
+    pMesh->fACMR                = header.fACMR;
+    pMesh->fATVR                = header.fATVR;
+    pMesh->pMeshFile            = pFile;
+    pMesh->nMeshFileBytes       = nBytes;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: saveSphereMesh()
+// Desc: Writes a generated sphere's client arrays to its mesh file, making
+//       the directory if need be. A sphere that can't be saved is only
+//       slower to start with next time, so failing is left to the caller
+//       to shrug off.
+//-----------------------------------------------------------------------------
+bool saveSphereMesh( const SphereMesh *pMesh, const char *pFileName, float r, int p, 
+                     GLuint nLayout )
+{
+    if( mkdir( g_pMeshFileDir, 0755 ) != 0 && errno != EEXIST )
+    {
+        cerr << "ERROR: saveSphereMesh - Couldn't create " << g_pMeshFileDir << "." << endl;
+        return false;
+    }
+
+    MeshFileHeader header;
+    memset( &header, 0, sizeof(header) );
+
+    header.nLayout         = nLayout;
+    header.nPrecision      = p;
+    header.fRadius         = r;
+    header.nVertexSize     = sizeof(Vertex);
+    header.nNumVertices    = pMesh->nNumVertices;
+    header.nIndexSize      = (pMesh->indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+    header.nNumIndices     = pMesh->nNumIndices;
+    header.nIndexPrimitive = pMesh->indexPrimitive;
+    header.nCacheSize      = g_nVertexCacheSize;
+    header.fACMR           = pMesh->fACMR;
+    header.fATVR           = pMesh->fATVR;
+
+    return writeMeshFile( pFileName, &header, pMesh->pVertices, pMesh->pIndices );
+}
+
+// The tables and array generateSphereVertices() hands the threads of the pool
+struct SphereGenerationJob
+{
+    const SphereTables *pTables;
+    Vertex             *pVertices;
+    int                 p;
+    int                 nFirstBand;
+};
+
+//-----------------------------------------------------------------------------
+// Name: generateSphereVertices()
+// Desc: Fills pVertices with the sphere's vertices for a layout. Every band 
+//       (or ring, for the indexed layouts) lands at an offset that only 
+//       depends on its number, so they're split across nNumThreads threads
+//       of the pool, each writing straight into the final array.
+//-----------------------------------------------------------------------------
+void generateSphereVertices( Vertex *pVertices, float cx, float cy, float cz, float r, int p, 
+                             GLuint nLayout, int nNumThreads )
+{
+    SphereTables tables;
+    createSphereTables( &tables, cx, cy, cz, r, p );
+
+    if( nLayout == STRIP_LAYOUT )
+        generateSphereBands( pVertices, &tables, p, 0, p/2, nNumThreads );
+    else
+    {
+        SphereGenerationJob job;
+        job.pTables    = &tables;
+        job.pVertices  = pVertices;
+        job.p          = p;
+        job.nFirstBand = 0;
+
+        runThreadPoolJob( generateIndexedRings, &job, p/2 + 1, nNumThreads );
+    }
+
+    destroySphereTables( &tables );
+}
+
+//-----------------------------------------------------------------------------
+// Name: generateSphereBands()
+// Desc: Writes the strips of nNumBands bands, starting at nFirstBand, to 
+//       pVertices using tables that were already made for precision p.
+//-----------------------------------------------------------------------------
+void generateSphereBands( Vertex *pVertices, const SphereTables *pTables, int p,
+                          int nFirstBand, int nNumBands, int nNumThreads )
+{
+    SphereGenerationJob job;
+    job.pTables    = pTables;
+    job.pVertices  = pVertices;
+    job.p          = p;
+    job.nFirstBand = nFirstBand;
+
+    runThreadPoolJob( generateStripBands, &job, nNumBands, nNumThreads );
+}
+
+//-----------------------------------------------------------------------------
+// Name: generateStripBands()
+// Desc: Thread pool job for the strip layout. Each band's strip alternates 
+//       between ring i+1 and ring i, so the two rings are written into every
+//       other vertex of the band.
+//-----------------------------------------------------------------------------
+void generateStripBands( void *pData, int nFirst, int nLast )
+{
+    SphereGenerationJob *pJob = (SphereGenerationJob *)pData;
+
+    for( int i = nFirst; i < nLast; ++i )
+    {
+        Vertex *pBand = pJob->pVertices + i * ((pJob->p+1)*2);
+        int     nBand = pJob->nFirstBand + i;
+
+        writeSphereRing( pJob->pTables, nBand + 1, &pBand[0].tu, 2, g_nSphereKernel );
+        writeSphereRing( pJob->pTables, nBand,     &pBand[1].tu, 2, g_nSphereKernel );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: generateIndexedRings()
+// Desc: Thread pool job for the indexed layouts, one ring after another.
+//-----------------------------------------------------------------------------
+void generateIndexedRings( void *pData, int nFirst, int nLast )
+{
+    SphereGenerationJob *pJob = (SphereGenerationJob *)pData;
+
+    for( int i = nFirst; i < nLast; ++i )
+    {
+        Vertex *pRing = pJob->pVertices + i * (pJob->p+1);
+
+        writeSphereRing( pJob->pTables, i, &pRing->tu, 1, g_nSphereKernel );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: createSphereStream()
+// Desc: Sets up the streaming mode. Nothing but the sin/cos tables is built 
+//       here, the vertices themselves are regenerated by 
+//       renderSphereStream() every frame, one chunk of bands at a time. By 
+//       now rebuildSphere() has handed the arrays of the other modes to the
+//       mesh cache, which keeps within its own budget, so the memory used 
+//       for the sphere stays at NUM_STREAM_BUFFERS chunks whatever the 
+//       precision.
+//-----------------------------------------------------------------------------
+void createSphereStream( void )
+{
+    int p = max( (int)g_nPrecision, 4 );
+
+    destroySphereTables( &g_streamTables );
+    createSphereTables( &g_streamTables, 0.0f, 0.0f, 0.0f, g_fSphereRadius, p );
+
+    // As many whole bands as fit in a chunk, but at least one
+    int nBandBytes = (p+1)*2 * sizeof(Vertex);
+
+    g_nStreamChunkBands  = max( STREAM_CHUNK_BYTES / nBandBytes, 1 );
+    g_nStreamChunkBands  = min( g_nStreamChunkBands, p/2 );
+    g_nStreamChunks      = (p/2 + g_nStreamChunkBands - 1) / g_nStreamChunkBands;
+    g_nNumSphereVertices = getNumLayoutVertices( STRIP_LAYOUT, p );
+
+    // Each chunk is its own strip, so there's no stitching triangle between
+    // the last band of one chunk and the first band of the next
+    g_fSphereACMR = g_nNumSphereVertices / (float)(g_nNumSphereVertices - 2*g_nStreamChunks);
+    g_fSphereATVR = 1.0f;
+
+    if( g_streamVBOs[0] == 0 )
+        glGenBuffers( NUM_STREAM_BUFFERS, g_streamVBOs );
+
+    for( int i = 0; i < NUM_STREAM_BUFFERS; ++i )
+    {
+        glBindBuffer( GL_ARRAY_BUFFER, g_streamVBOs[i] );
+        glBufferData( GL_ARRAY_BUFFER, g_nStreamChunkBands * nBandBytes, NULL, GL_STREAM_DRAW );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+//-----------------------------------------------------------------------------
+// Name: renderSphereStream()
+// Desc: Generates the sphere a chunk of bands at a time straight into the 
+//       next buffer object of the ring, and draws each chunk as soon as it's
+//       full. Mapping with GL_MAP_INVALIDATE_BUFFER_BIT lets the driver hand 
+//       back fresh storage if the GPU is still reading the buffer's last 
+//       chunk, rather than stalling.
+//-----------------------------------------------------------------------------
+void renderSphereStream( void )
+{
+    int p          = g_streamTables.nNumColumns - 1;
+    int nBandVerts = (p+1)*2;
+
+    for( int nChunk = 0; nChunk < g_nStreamChunks; ++nChunk )
+    {
+        int nFirstBand = nChunk * g_nStreamChunkBands;
+        int nNumBands  = min( g_nStreamChunkBands, p/2 - nFirstBand );
+
+        glBindBuffer( GL_ARRAY_BUFFER, g_streamVBOs[nChunk % NUM_STREAM_BUFFERS] );
+
+        Vertex *pVertices = (Vertex *)glMapBufferRange( GL_ARRAY_BUFFER, 0, 
+                                                        nNumBands * nBandVerts * sizeof(Vertex),
+                                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT );
+        if( pVertices == NULL )
+        {
+            cerr << "ERROR: renderSphereStream - glMapBufferRange failed." << endl;
+            break;
+        }
+
+        generateSphereBands( pVertices, &g_streamTables, p, nFirstBand, nNumBands, g_nGenerationThreads );
+        glUnmapBuffer( GL_ARRAY_BUFFER );
+
+        glInterleavedArrays( GL_T2F_N3F_V3F, 0, (const GLvoid *)0 );
+        glDrawArrays( GL_TRIANGLE_STRIP, 0, nNumBands * nBandVerts );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+//-----------------------------------------------------------------------------
+// Name: createSphereProcedural()
+// Desc: Sets up the procedural mode, which has nothing to build but its 
+//       shader. The vertex shader walks the same single strip the strip 
+//       layout stores, band after band, with two vertices per column 
+//       alternating between ring i+1 and ring i, and uses the same formulas
+//       as createSphereTables() for each of them.
+//-----------------------------------------------------------------------------
+void createSphereProcedural( void )
+{
+    int p = max( (int)g_nPrecision, 4 );
+
+    g_nProceduralPrecision = p;
+    g_nNumSphereVertices   = getNumLayoutVertices( STRIP_LAYOUT, p );
+    g_fSphereACMR          = g_nNumSphereVertices / (float)(g_nNumSphereVertices - 2);
+    g_fSphereATVR          = 1.0f;
+
+    if( g_proceduralProgram != 0 )
+        return;
+
+    // gl_VertexID needs GLSL 1.30. The normal n isn't passed on, since the
+    // sphere is drawn unlit like in the other modes.
+    const char *pVertexSource =
+        "#version 130\n"
+        "uniform int spherePrecision;\n"
+        "uniform float sphereRadius;\n"
+        "out vec2 sphereTexCoord;\n"
+        "void main()\n"
+        "{\n"
+        "    const float TWOPI  = 6.28318530717958;\n"
+        "    const float PIDIV2 = 1.57079632679489;\n"
+        "    int   nBandVerts = (spherePrecision + 1) * 2;\n"
+        "    int   nBand      = gl_VertexID / nBandVerts;\n"
+        "    int   k          = gl_VertexID - nBand * nBandVerts;\n"
+        "    int   nColumn    = k / 2;\n"
+        "    int   nRing      = nBand + 1 - (k & 1);\n"
+        "    float p          = float( spherePrecision );\n"
+        "    float theta1     = float( nRing ) * TWOPI / p - PIDIV2;\n"
+        "    float theta3     = float( nColumn ) * TWOPI / p;\n"
+        "    vec3  n          = vec3( cos( theta1 ) * cos( theta3 ), sin( theta1 ), \n"
+        "                             cos( theta1 ) * sin( theta3 ) );\n"
+        "    vec4  t          = vec4( -float( nColumn ) / p, 2.0 * float( nRing ) / p, 0.0, 1.0 );\n"
+        "    sphereTexCoord = (gl_TextureMatrix[0] * t).xy;\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * vec4( sphereRadius * n, 1.0 );\n"
+        "}\n";
+
+    const char *pFragmentSource =
+        "#version 130\n"
+        "uniform sampler2D marsTexture;\n"
+        "in vec2 sphereTexCoord;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_FragColor = texture( marsTexture, sphereTexCoord );\n"
+        "}\n";
+
+    g_proceduralProgram = createShaderProgram( pVertexSource, pFragmentSource, NULL, 0 );
+
+    if( g_proceduralProgram == 0 )
+    {
+        cerr << "ERROR: createSphereProcedural - The procedural mode won't draw anything." << endl;
+        return;
+    }
+
+    g_nProceduralPrecisionLoc = glGetUniformLocation( g_proceduralProgram, "spherePrecision" );
+    g_nProceduralRadiusLoc    = glGetUniformLocation( g_proceduralProgram, "sphereRadius" );
+}
+
+//-----------------------------------------------------------------------------
+// Name: renderSphereProcedural()
+// Desc: Draws the sphere with no arrays enabled at all. The compatibility 
+//       profile allows that, and Mesa, llvmpipe included, runs the vertex 
+//       shader once per index of the draw.
+//-----------------------------------------------------------------------------
+void renderSphereProcedural( void )
+{
+    if( g_proceduralProgram == 0 )
+        return;
+
+    glUseProgram( g_proceduralProgram );
+    glUniform1i( g_nProceduralPrecisionLoc, g_nProceduralPrecision );
+    glUniform1f( g_nProceduralRadiusLoc, g_fSphereRadius );
+
+    glDrawArrays( GL_TRIANGLE_STRIP, 0, g_nNumSphereVertices );
+
+    glUseProgram( 0 );
+}
+
+//-----------------------------------------------------------------------------
+// Name: createSphereImpostor()
+// Desc: Sets up the impostor mode. The sphere is a single quad facing the 
+//       eye, big enough to hold the sphere's silhouette, and the fragment 
+//       shader intersects each pixel's view ray with the exact sphere. It 
+//       writes the depth of the hit, and takes the texture coordinates from
+//       the normal with the same mapping the tessellated sphere uses, so 
+//       the vertex cost stays at 4 vertices whatever g_nPrecision is and it
+//       all comes down to fill rate.
+//-----------------------------------------------------------------------------
+void createSphereImpostor( void )
+{
+    g_nNumSphereVertices = 4;
+    g_fSphereACMR        = 2.0f;
+    g_fSphereATVR        = 1.0f;
+
+    if( g_impostorProgram != 0 )
+        return;
+
+    // The quad lies in the plane through the center, facing the eye. The 
+    // cone of view rays that touch a sphere of radius r at distance d cuts
+    // that plane in a circle of radius r * d / sqrt(d*d - r*r).
+    const char *pVertexSource =
+        "#version 130\n"
+        "uniform float sphereRadius;\n"
+        "out vec3 viewPosition;\n"
+        "flat out vec3 sphereCenter;\n"
+        "flat out float sphereViewRadius;\n"
+        "void main()\n"
+        "{\n"
+        "    vec3  c      = (gl_ModelViewMatrix * vec4( 0.0, 0.0, 0.0, 1.0 )).xyz;\n"
+        "    float r      = sphereRadius * length( gl_ModelViewMatrix[0].xyz );\n"
+        "    float d      = length( c );\n"
+        "    vec3  w      = c / d;\n"
+        "    vec3  up     = (abs( w.y ) > 0.99) ? vec3( 1.0, 0.0, 0.0 ) : vec3( 0.0, 1.0, 0.0 );\n"
+        "    vec3  u      = normalize( cross( w, up ) );\n"
+        "    vec3  v      = cross( u, w );\n"
+        "    float size   = r * d / sqrt( max( d * d - r * r, 1e-6 ) );\n"
+        "    vec2  corner = vec2( float( gl_VertexID & 1 ), float( gl_VertexID >> 1 ) ) * 2.0 - 1.0;\n"
+        "    viewPosition     = c + size * (corner.x * u + corner.y * v);\n"
+        "    sphereCenter     = c;\n"
+        "    sphereViewRadius = r;\n"
+        "    gl_Position = gl_ProjectionMatrix * vec4( viewPosition, 1.0 );\n"
+        "}\n";
+
+    // The texture coordinate jumps by 1 where the longitude wraps around, 
+    // so the gradients are taken from whichever of u and fract(u) is smooth
+    // at the pixel, or a mipmapped texture would blur along the seam.
+    const char *pFragmentSource =
+        "#version 130\n"
+        "uniform sampler2D marsTexture;\n"
+        "in vec3 viewPosition;\n"
+        "flat in vec3 sphereCenter;\n"
+        "flat in float sphereViewRadius;\n"
+        "void main()\n"
+        "{\n"
+        "    const float PI    = 3.14159265358979;\n"
+        "    const float TWOPI = 6.28318530717958;\n"
+        "    vec3  ray  = normalize( viewPosition );\n"
+        "    float b    = dot( ray, sphereCenter );\n"
+        "    float disc = b * b - dot( sphereCenter, sphereCenter ) + sphereViewRadius * sphereViewRadius;\n"
+        "    if( disc < 0.0 )\n"
+        "        discard;\n"
+        "    vec3  p    = (b - sqrt( disc )) * ray;\n"
+        "    vec4  clip = gl_ProjectionMatrix * vec4( p, 1.0 );\n"
+        "    gl_FragDepth = 0.5 * (gl_DepthRange.diff * clip.z / clip.w + \n"
+        "                          gl_DepthRange.near + gl_DepthRange.far);\n"
+        "    vec3  n    = normalize( transpose( mat3( gl_ModelViewMatrix ) ) * (p - sphereCenter) );\n"
+        "    float tu   = -atan( n.z, n.x ) / TWOPI;\n"
+        "    float tv   = (asin( clamp( n.y, -1.0, 1.0 ) ) + PI / 2.0) / PI;\n"
+        "    float tu2  = fract( tu );\n"
+        "    vec2  du   = vec2( dFdx( tu ), dFdy( tu ) );\n"
+        "    vec2  du2  = vec2( dFdx( tu2 ), dFdy( tu2 ) );\n"
+        "    if( dot( du2, du2 ) < dot( du, du ) )\n"
+        "        du = du2;\n"
+        "    mat2  m    = mat2( gl_TextureMatrix[0] );\n"
+        "    vec2  t    = (gl_TextureMatrix[0] * vec4( tu, tv, 0.0, 1.0 )).xy;\n"
+        "    gl_FragColor = textureGrad( marsTexture, t, m * vec2( du.x, dFdx( tv ) ), \n"
+        "                                m * vec2( du.y, dFdy( tv ) ) );\n"
+        "}\n";
+
+    g_impostorProgram = createShaderProgram( pVertexSource, pFragmentSource, NULL, 0 );
+
+    if( g_impostorProgram == 0 )
+    {
+        cerr << "ERROR: createSphereImpostor - The impostor mode won't draw anything." << endl;
+        return;
+    }
+
+    g_nImpostorRadiusLoc = glGetUniformLocation( g_impostorProgram, "sphereRadius" );
+}
+
+//-----------------------------------------------------------------------------
+// Name: renderSphereImpostor()
+// Desc: Draws the sphere's quad, which like the procedural sphere needs no 
+//       arrays at all. The corners come from gl_VertexID.
+//-----------------------------------------------------------------------------
+void renderSphereImpostor( void )
+{
+    if( g_impostorProgram == 0 )
+        return;
+
+    glUseProgram( g_impostorProgram );
+    glUniform1f( g_nImpostorRadiusLoc, g_fSphereRadius );
+
+    glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+
+    glUseProgram( 0 );
+}
+
+//-----------------------------------------------------------------------------
+// Name: createSphereSoftware()
+// Desc: Makes room for the current sphere's transformed vertices. The
+//       array only ever grows, since every sphere of the scene is
+//       transformed into it in turn.
+//-----------------------------------------------------------------------------
+void createSphereSoftware( void )
+{
+    if( g_nMaxTransformedVertices >= g_nNumSphereVertices )
+        return;
+
+    free( g_pTransformedVertices );
+
+    g_nMaxTransformedVertices = g_nNumSphereVertices;
+    g_pTransformedVertices    = (GLfloat *)malloc( (size_t)g_nMaxTransformedVertices *
+                                                   TRANSFORMED_VERTEX_FLOATS * sizeof(GLfloat) );
+}
+
+// The matrices renderSphereSoftware() hands the threads of the pool
+struct SphereTransformJob
+{
+    GLfloat matrix[16];
+    GLfloat normalMatrix[9];
+};
+
+//-----------------------------------------------------------------------------
+// Name: renderSphereSoftware()
+// Desc: Transforms the current sphere with the current matrices on the CPU,
+//       then draws the clip-space positions and eye-space normals with
+//       identity matrices, so all the driver has left to do is clip and
+//       rasterize. The texture coordinates are passed through untouched,
+//       straight from g_pSphereVertices.
+//-----------------------------------------------------------------------------
+void renderSphereSoftware( void )
+{
+    SphereTransformJob job;
+    GLfloat            modelView[16];
+    GLfloat            projection[16];
+
+    glGetFloatv( GL_MODELVIEW_MATRIX, modelView );
+    glGetFloatv( GL_PROJECTION_MATRIX, projection );
+
+    multiplyMatrices( projection, modelView, job.matrix );
+    getNormalMatrix( modelView, job.normalMatrix );
+
+    uint64_t nStart  = getTimeNanoseconds();
+    int      nBlocks = (g_nNumSphereVertices + TRANSFORM_BLOCK_VERTICES - 1) / TRANSFORM_BLOCK_VERTICES;
+
+    runThreadPoolJob( transformSphereBlocks, &job, nBlocks, g_nGenerationThreads );
+
+    g_fTransformTime += (getTimeNanoseconds() - nStart) / 1000000.0f;
+
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix();
+    glLoadIdentity();
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix();
+    glLoadIdentity();
+
+    GLsizei nStride = TRANSFORMED_VERTEX_FLOATS * sizeof(GLfloat);
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    glVertexPointer( 4, GL_FLOAT, nStride, g_pTransformedVertices );
+    glNormalPointer( GL_FLOAT, nStride, g_pTransformedVertices + 4 );
+    glTexCoordPointer( 2, GL_FLOAT, sizeof(Vertex), &g_pSphereVertices->tu );
+
+    if( g_nSphereLayout != STRIP_LAYOUT )
+        glDrawElements( g_sphereIndexPrimitive, g_nNumSphereIndices, g_sphereIndexType, g_pSphereIndices );
+    else
+        glDrawArrays( GL_TRIANGLE_STRIP, 0, g_nNumSphereVertices );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix();
+    glMatrixMode( GL_MODELVIEW );
+    glPopMatrix();
+}
+
+//-----------------------------------------------------------------------------
+// Name: transformSphereBlocks()
+// Desc: Thread pool job for the software T&L, TRANSFORM_BLOCK_VERTICES of
+//       the current sphere's vertices per item.
+//-----------------------------------------------------------------------------
+void transformSphereBlocks( void *pData, int nFirst, int nLast )
+{
+    SphereTransformJob *pJob   = (SphereTransformJob *)pData;
+    int                 nBegin = nFirst * TRANSFORM_BLOCK_VERTICES;
+    int                 nEnd   = min( nLast * TRANSFORM_BLOCK_VERTICES, (int)g_nNumSphereVertices );
+
+    transformVertices( pJob->matrix, pJob->normalMatrix,
+                       &(g_pSphereVertices + nBegin)->tu,
+                       g_pTransformedVertices + nBegin * TRANSFORMED_VERTEX_FLOATS,
+                       nEnd - nBegin, g_nSphereKernel );
+}
+
+//-----------------------------------------------------------------------------
+// Name: getNumLayoutVertices()
+// Desc: Vertices a sphere of precision p needs in a layout.
+//-----------------------------------------------------------------------------
+GLuint getNumLayoutVertices( GLuint nLayout, int p )
+{
+    if( nLayout == STRIP_LAYOUT )
+        return (p/2) * ((p+1)*2);
+
+    return (p/2 + 1) * (p+1);
+}
+
+//-----------------------------------------------------------------------------
+// Name: setIndexData()
+// Desc: Helper function for generateIndexedSphereMesh()
+//-----------------------------------------------------------------------------
+void setIndexData( SphereMesh *pMesh, int index, GLuint value )
+{
+    if( pMesh->indexType == GL_UNSIGNED_SHORT )
+        ((GLushort *)pMesh->pIndices)[index] = (GLushort)value;
+    else
+        ((GLuint *)pMesh->pIndices)[index] = value;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getIndexData()
+// Desc: Reads back an entry of g_pSphereIndices, whatever its width.
+//-----------------------------------------------------------------------------
+GLuint getIndexData( int index )
+{
+    if( g_sphereIndexType == GL_UNSIGNED_SHORT )
+        return ((GLushort *)g_pSphereIndices)[index];
+    else
+        return ((GLuint *)g_pSphereIndices)[index];
+}
+
+//-----------------------------------------------------------------------------
+// Name: getIndexSize()
+// Desc: Size in bytes of one entry of g_pSphereIndices.
+//-----------------------------------------------------------------------------
+GLuint getIndexSize( void )
+{
+    return (g_sphereIndexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+}
+
+//-----------------------------------------------------------------------------
+// Name: generateIndexedSphereMesh()
+// Desc: Same sphere as generateSphereMesh(), but every (i, j) grid vertex 
+//       is generated once and shared by the two bands that touch it. 
+//
+//       For INDEXED_LAYOUT the index list walks the bands in exactly the 
+//       same order as the strip layout, so both draw the same 
+//       GL_TRIANGLE_STRIP. For OPTIMIZED_LAYOUT each quad of the grid becomes
+//       two GL_TRIANGLES, which are then reordered for the post-transform 
+//       vertex cache.
+//-----------------------------------------------------------------------------
+void generateIndexedSphereMesh( SphereMesh *pMesh, float cx, float cy, float cz, float r, int p,
+                                GLuint nLayout )
+{
+    // Disallow a negative number for radius.
+    if( r < 0 )
+        r = -r;
+
+    // Disallow a negative number for precision.
+    if( p < 4 ) 
+        p = 4;
+
+    //-------------------------------------------------------------------------
+    // The grid has (p/2)+1 rings of (p+1) vertices each, while the strips 
+    // still need two indices per ring vertex for each of the p/2 bands, and
+    // the triangle list needs six indices for each of the (p/2)*p quads.
+    //
+    // Example:
+    //
+    // total_verts     = ((p/2)+1) * (p+1) = 3 * 5      = 15
+    // strip_indices   =  (p/2) * ((p+1)*2) = 2 * (5*2) = 20
+    // list_indices    =  (p/2) * p * 6     = 2 * 4 * 6 = 48
+    //-------------------------------------------------------------------------
+
+    int nNumRows    = p/2 + 1;
+    int nNumColumns = p + 1;
+
+    pMesh->nNumVertices = nNumRows * nNumColumns;
+
+    if( nLayout == OPTIMIZED_LAYOUT )
+    {
+        pMesh->indexPrimitive = GL_TRIANGLES;
+        pMesh->nNumIndices    = (p/2) * p * 6;
+    }
+    else
+    {
+        pMesh->indexPrimitive = GL_TRIANGLE_STRIP;
+        pMesh->nNumIndices    = (p/2) * (nNumColumns*2);
+    }
+
+    // 16 bit indices can address 65536 vertices
+    pMesh->indexType = (pMesh->nNumVertices <= 65536) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    GLuint nIndexSize = (pMesh->indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+
+    pMesh->pVertices = new Vertex[pMesh->nNumVertices];
+    pMesh->pIndices  = malloc( pMesh->nNumIndices * nIndexSize );
+
+    generateSphereVertices( pMesh->pVertices, cx, cy, cz, r, p, 
+                            nLayout, g_nGenerationThreads );
+
+    //
+    // The indices are built at full width first, since that's what the 
+    // optimizer and the cache simulator work on.
+    //
+
+    GLuint *pIndices = new GLuint[pMesh->nNumIndices];
+
+    int k = -1;
+
+    for( int i = 0; i < p/2; ++i )
+    {
+        if( pMesh->indexPrimitive == GL_TRIANGLES )
+        {
+            for( int j = 0; j < p; ++j )
+            {
+                // Same winding as the strip: (a, b, c) then (c, b, d)
+                GLuint a = (i + 1) * nNumColumns + j;
+                GLuint b = i * nNumColumns + j;
+                GLuint c = a + 1;
+                GLuint d = b + 1;
+
+                pIndices[++k] = a; pIndices[++k] = b; pIndices[++k] = c;
+                pIndices[++k] = c; pIndices[++k] = b; pIndices[++k] = d;
+            }
+        }
+        else
+        {
+            for( int j = 0; j < nNumColumns; ++j )
+            {
+                pIndices[++k] = (i + 1) * nNumColumns + j;
+                pIndices[++k] = i * nNumColumns + j;
+            }
+        }
+    }
+
+    if( nLayout == OPTIMIZED_LAYOUT )
+        optimizeVertexCache( pIndices, pMesh->nNumIndices, pMesh->nNumVertices );
+
+    int nNumMisses = simulateVertexCache( pIndices, pMesh->nNumIndices, 
+                                          pMesh->nNumVertices, g_nVertexCacheSize );
+
+    GLuint nNumTriangles = (pMesh->indexPrimitive == GL_TRIANGLES) ? 
+                           pMesh->nNumIndices / 3 : pMesh->nNumIndices - 2;
+
+    pMesh->fACMR = nNumMisses / (float)nNumTriangles;
+    pMesh->fATVR = nNumMisses / (float)pMesh->nNumVertices;
+
+    for( GLuint n = 0; n < pMesh->nNumIndices; ++n )
+        setIndexData( pMesh, n, pIndices[n] );
+
+    delete []pIndices;
+}
+
+//-----------------------------------------------------------------------------
+// Name: generateIcosphereMesh()
+// Desc: Subdivides each face of the icosahedron from geometry.h into n*n
+//       triangles and pushes the new points out onto the sphere, with n
+//       picked by getIcosphereFrequency() for the precision p. The texture
+//       is mapped the same way as on the UV sphere, so triangles crossing
+//       the seam get their own copies of the vertices on the tu = 0 side,
+//       and every triangle touching a pole gets its own copy of the pole.
+//-----------------------------------------------------------------------------
+void generateIcosphereMesh( SphereMesh *pMesh, float cx, float cy, float cz, float r, int p )
+{
+    const double TWOPI = 6.28318530717958;
+    const double PI    = 3.14159265358979;
+
+    // Disallow a negative number for radius.
+    if( r < 0 )
+        r = -r;
+
+    // Disallow a negative number for precision.
+    if( p < 4 )
+        p = 4;
+
+    int n = getIcosphereFrequency( p, r );
+
+    //-------------------------------------------------------------------------
+    // The 12 corners come first, then the n-1 points inside each of the 30
+    // edges, then the points inside each of the 20 faces, so the points two
+    // faces share are only stored once.
+    //
+    // Example:
+    //
+    // total_points = 12 + 30*(n-1) + 20*((n-1)*(n-2)/2) = 10*n*n + 2
+    // total_points = 12 + 30*  3   + 20*(  3  *  2  /2) = 162         (n = 4)
+    //-------------------------------------------------------------------------
+
+    int anEdges[30][2];
+    int anFaceEdges[20][3];
+    int nNumEdges = 0;
+
+    for( int f = 0; f < 20; ++f )
+    {
+        for( int k = 0; k < 3; ++k )
+        {
+            int a = icos_v[f][k];
+            int b = icos_v[f][(k + 1) % 3];
+            int e;
+
+            for( e = 0; e < nNumEdges; ++e )
+            {
+                if( (anEdges[e][0] == a && anEdges[e][1] == b) ||
+                    (anEdges[e][0] == b && anEdges[e][1] == a) )
+                    break;
+            }
+
+            if( e == nNumEdges )
+            {
+                anEdges[e][0] = a;
+                anEdges[e][1] = b;
+                ++nNumEdges;
+            }
+
+            anFaceEdges[f][k] = e;
+        }
+    }
+
+    GLuint  nNumPoints    = 10*(GLuint)(n*n) + 2;
+    GLuint  nNumIndices   = 20*(GLuint)(n*n) * 3;
+    Vertex *pPoints       = new Vertex[nNumPoints];
+    GLuint *pIndices      = new GLuint[nNumIndices];
+    int     k             = -1;
+
+    for( int f = 0; f < 20; ++f )
+    {
+        // Turned a quarter around z, which puts corners 0 and 11 on the
+        // poles of the texture at +y and -y
+        double corners[3][3];
+
+        for( int c = 0; c < 3; ++c )
+        {
+            corners[c][0] = -icos_r[icos_v[f][c]][1];
+            corners[c][1] =  icos_r[icos_v[f][c]][0];
+            corners[c][2] =  icos_r[icos_v[f][c]][2];
+        }
+
+        for( int i = 0; i <= n; ++i )
+        {
+            for( int j = 0; j <= n - i; ++j )
+            {
+                double dir[3];
+
+                for( int c = 0; c < 3; ++c )
+                    dir[c] = corners[0][c] + (corners[1][c] - corners[0][c]) * i / n +
+                                             (corners[2][c] - corners[0][c]) * j / n;
+
+                double dLength = sqrt( dir[0]*dir[0] + dir[1]*dir[1] + dir[2]*dir[2] );
+                double theta3  = atan2( dir[2], dir[0] );
+
+                if( theta3 < 0.0 )
+                    theta3 += TWOPI;
+
+                Vertex *pPoint = pPoints + getIcosphereIndex( anEdges, anFaceEdges, n, f, i, j );
+
+                pPoint->nx = (float)(dir[0] / dLength);
+                pPoint->ny = (float)(dir[1] / dLength);
+                pPoint->nz = (float)(dir[2] / dLength);
+                pPoint->vx = cx + r * pPoint->nx;
+                pPoint->vy = cy + r * pPoint->ny;
+                pPoint->vz = cz + r * pPoint->nz;
+                pPoint->tu = (float)(-theta3 / TWOPI);
+                pPoint->tv = (float)((asin( dir[1] / dLength ) + PI/2) / PI);
+
+                // Same winding as the face: (a, b, c) then (b, d, c)
+                if( i + j < n )
+                {
+                    GLuint a = getIcosphereIndex( anEdges, anFaceEdges, n, f, i,     j     );
+                    GLuint b = getIcosphereIndex( anEdges, anFaceEdges, n, f, i + 1, j     );
+                    GLuint c = getIcosphereIndex( anEdges, anFaceEdges, n, f, i,     j + 1 );
+
+                    pIndices[++k] = a; pIndices[++k] = b; pIndices[++k] = c;
+
+                    if( i + j < n - 1 )
+                    {
+                        GLuint d = getIcosphereIndex( anEdges, anFaceEdges, n, f, i + 1, j + 1 );
+
+                        pIndices[++k] = b; pIndices[++k] = d; pIndices[++k] = c;
+                    }
+                }
+            }
+        }
+    }
+
+    //
+    // A triangle whose tu spans more than half the texture straddles the
+    // seam, so its vertices on the tu = 0 side use a copy at tu - 1. The
+    // poles, 0 and 11, have no tu of their own and get a copy for every
+    // triangle with the mean tu of its other two vertices. The copies are
+    // counted first and written on the second pass.
+    //
+
+    GLuint *pSeamCopies    = new GLuint[nNumPoints];
+    GLuint  nNumSeamCopies = 0;
+    GLuint  nNumPoleCopies = 0;
+
+    for( GLuint v = 0; v < nNumPoints; ++v )
+        pSeamCopies[v] = 0;
+
+    for( int nPass = 0; nPass < 2; ++nPass )
+    {
+        GLuint nNextPole = nNumPoints + nNumSeamCopies;
+
+        for( GLuint t = 0; t < nNumIndices; t += 3 )
+        {
+            GLuint *pTriangle = pIndices + t;
+            float   fMinTu    =  1.0f;
+            float   fMaxTu    = -2.0f;
+            int     nPole     = -1;
+
+            for( int c = 0; c < 3; ++c )
+            {
+                if( pTriangle[c] == 0 || pTriangle[c] == 11 )
+                {
+                    nPole = c;
+                    continue;
+                }
+
+                fMinTu = min( fMinTu, pPoints[pTriangle[c]].tu );
+                fMaxTu = max( fMaxTu, pPoints[pTriangle[c]].tu );
+            }
+
+            for( int c = 0; c < 3 && fMaxTu - fMinTu > 0.5f; ++c )
+            {
+                if( c == nPole || pPoints[pTriangle[c]].tu < -0.5f )
+                    continue;
+
+                if( pSeamCopies[pTriangle[c]] == 0 )
+                    pSeamCopies[pTriangle[c]] = nNumPoints + nNumSeamCopies++;
+
+                if( nPass == 1 )
+                    pTriangle[c] = pSeamCopies[pTriangle[c]];
+            }
+
+            if( nPole < 0 )
+                continue;
+
+            if( nPass == 0 )
+            {
+                ++nNumPoleCopies;
+                continue;
+            }
+
+            Vertex *pPole = pMesh->pVertices + nNextPole;
+
+            *pPole     = pPoints[pTriangle[nPole]];
+            pPole->tu  = (pMesh->pVertices[pTriangle[(nPole + 1) % 3]].tu +
+                          pMesh->pVertices[pTriangle[(nPole + 2) % 3]].tu) / 2.0f;
+
+            pTriangle[nPole] = nNextPole++;
+        }
+
+        if( nPass == 1 )
+            break;
+
+        pMesh->nNumVertices = nNumPoints + nNumSeamCopies + nNumPoleCopies;
+        pMesh->pVertices    = new Vertex[pMesh->nNumVertices];
+
+        memcpy( pMesh->pVertices, pPoints, nNumPoints * sizeof(Vertex) );
+
+        for( GLuint v = 0; v < nNumPoints; ++v )
+        {
+            if( pSeamCopies[v] == 0 )
+                continue;
+
+            pMesh->pVertices[pSeamCopies[v]]     = pPoints[v];
+            pMesh->pVertices[pSeamCopies[v]].tu -= 1.0f;
+        }
+    }
+
+    delete []pSeamCopies;
+    delete []pPoints;
+
+    pMesh->indexPrimitive = GL_TRIANGLES;
+    pMesh->nNumIndices    = nNumIndices;
+
+    // 16 bit indices can address 65536 vertices
+    pMesh->indexType = (pMesh->nNumVertices <= 65536) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    GLuint nIndexSize = (pMesh->indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+
+    pMesh->pIndices = malloc( pMesh->nNumIndices * nIndexSize );
+
+    // Face by face and row by row already reuses a lot, but it's drawn
+    // against the cache-optimized UV sphere
+    optimizeVertexCache( pIndices, pMesh->nNumIndices, pMesh->nNumVertices );
+
+    int nNumMisses = simulateVertexCache( pIndices, pMesh->nNumIndices,
+                                          pMesh->nNumVertices, g_nVertexCacheSize );
+
+    pMesh->fACMR = nNumMisses / (float)(pMesh->nNumIndices / 3);
+    pMesh->fATVR = nNumMisses / (float)pMesh->nNumVertices;
+
+    for( GLuint v = 0; v < pMesh->nNumIndices; ++v )
+        setIndexData( pMesh, v, pIndices[v] );
+
+    delete []pIndices;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getIcosphereIndex()
+// Desc: The point i steps from the first corner of face f towards the
+//       second and j steps towards the third, numbered the way
+//       generateIcosphereMesh() stores them.
+//-----------------------------------------------------------------------------
+GLuint getIcosphereIndex( const int anEdges[30][2], const int anFaceEdges[20][3], int n,
+                          int f, int i, int j )
+{
+    const int *pCorners = icos_v[f];
+
+    if( i == 0 && j == 0 )
+        return pCorners[0];
+
+    if( i == n )
+        return pCorners[1];
+
+    if( j == n )
+        return pCorners[2];
+
+    int nEdge;
+    int nFrom;
+    int nStep;
+
+    if( j == 0 )
+    {
+        nEdge = anFaceEdges[f][0];
+        nFrom = pCorners[0];
+        nStep = i;
+    }
+    else if( i + j == n )
+    {
+        nEdge = anFaceEdges[f][1];
+        nFrom = pCorners[1];
+        nStep = j;
+    }
+    else if( i == 0 )
+    {
+        nEdge = anFaceEdges[f][2];
+        nFrom = pCorners[2];
+        nStep = n - j;
+    }
+    else
+    {
+        // Row i of the inside of the face holds the points j = 1 to n-1-i
+        return 12 + 30*(n-1) + f*((n-1)*(n-2)/2) + (i-1)*(n-1) - (i-1)*i/2 + (j-1);
+    }
+
+    // Edges are numbered from their first corner
+    if( nFrom != anEdges[nEdge][0] )
+        nStep = n - nStep;
+
+    return 12 + nEdge*(n-1) + (nStep-1);
+}
+
+//-----------------------------------------------------------------------------
+// Name: getIcosphereFrequency()
+// Desc: The fewest steps along each edge of the icosahedron that leave no
+//       edge of the icosphere longer than the longest edge of the UV sphere
+//       of precision p.
+//-----------------------------------------------------------------------------
+int getIcosphereFrequency( int p, float r )
+{
+    const double EDGE     = 1.05146222424; // Icosahedron edge, unit circumradius
+    const double INRADIUS = 0.79465447229; // Distance from centre to a face
+
+    float fTarget;
+    getUVSphereError( p, r, &fTarget );
+
+    // Pushed out onto the sphere, no piece of a face gets longer than
+    // 1/INRADIUS times its flat length, so nHigh steps are always enough
+    double theta = 2.0 * asin( min( fTarget / (2.0 * r), 1.0 ) );
+    int    nLow  = 1;
+    int    nHigh = max( (int)ceil( EDGE / (INRADIUS * theta) ), 1 );
+
+    while( nLow < nHigh )
+    {
+        int   nMid = (nLow + nHigh) / 2;
+        float fMaxEdge;
+
+        getIcosphereError( nMid, r, &fMaxEdge );
+
+        if( fMaxEdge <= fTarget )
+            nHigh = nMid;
+        else
+            nLow = nMid + 1;
+    }
+
+    return nLow;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getIcosphereError()
+// Desc: Measures one face, since all 20 are the same.
+//-----------------------------------------------------------------------------
+float getIcosphereError( int n, float r, float *pfMaxEdge )
+{
+    double dMaxEdge  = 0.0;
+    double dMaxError = 0.0;
+
+    const double *A = icos_r[icos_v[0][0]];
+    const double *B = icos_r[icos_v[0][1]];
+    const double *C = icos_r[icos_v[0][2]];
+
+    // Two rows of points at a time, i and i+1
+    double *pRow  = new double[(n+1) * 3];
+    double *pNext = new double[(n+1) * 3];
+
+    for( int i = 0; i <= n; ++i )
+    {
+        for( int j = 0; j <= n - i; ++j )
+        {
+            double *pPoint = pNext + j * 3;
+
+            for( int c = 0; c < 3; ++c )
+                pPoint[c] = A[c] + (B[c] - A[c]) * i / n + (C[c] - A[c]) * j / n;
+
+            double dScale = r / sqrt( pPoint[0]*pPoint[0] + pPoint[1]*pPoint[1] + pPoint[2]*pPoint[2] );
+
+            for( int c = 0; c < 3; ++c )
+                pPoint[c] *= dScale;
+        }
+
+        // Row i-1 is in pRow, with one more point than row i
+        for( int j = 0; i > 0 && j < n - i + 1; ++j )
+        {
+            double dError = getTriangleError( pRow + j*3, pNext + j*3, pRow + (j+1)*3, r, &dMaxEdge );
+            dMaxError = max( dMaxError, dError );
+
+            if( j < n - i )
+            {
+                dError = getTriangleError( pNext + j*3, pNext + (j+1)*3, pRow + (j+1)*3, r, &dMaxEdge );
+                dMaxError = max( dMaxError, dError );
+            }
+        }
+
+        swap( pRow, pNext );
+    }
+
+    delete []pRow;
+    delete []pNext;
+
+    *pfMaxEdge = (float)dMaxEdge;
+
+    return (float)dMaxError;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getUVSphereError()
+// Desc: Measures one column of quads, since they're all the same.
+//-----------------------------------------------------------------------------
+float getUVSphereError( int p, float r, float *pfMaxEdge )
+{
+    const double TWOPI  = 6.28318530717958;
+    const double PIDIV2 = 1.57079632679489;
+
+    double dMaxEdge  = 0.0;
+    double dMaxError = 0.0;
+    double theta3    = TWOPI / p;
+
+    for( int i = 0; i < p/2; ++i )
+    {
+        double theta1 = i * TWOPI / p - PIDIV2;
+        double theta2 = (i + 1) * TWOPI / p - PIDIV2;
+
+        // a and c on ring i+1, b and d on ring i, as the strip has them
+        double a[3] = { r * cos( theta2 ), r * sin( theta2 ), 0.0 };
+        double b[3] = { r * cos( theta1 ), r * sin( theta1 ), 0.0 };
+        double c[3] = { r * cos( theta2 ) * cos( theta3 ), a[1], r * cos( theta2 ) * sin( theta3 ) };
+        double d[3] = { r * cos( theta1 ) * cos( theta3 ), b[1], r * cos( theta1 ) * sin( theta3 ) };
+
+        dMaxError = max( dMaxError, getTriangleError( a, b, c, r, &dMaxEdge ) );
+        dMaxError = max( dMaxError, getTriangleError( c, b, d, r, &dMaxEdge ) );
+    }
+
+    *pfMaxEdge = (float)dMaxEdge;
+
+    return (float)dMaxError;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getEqualErrorPrecision()
+// Desc: The lowest even precision at which the UV sphere strays no further
+//       from the true sphere than fMaxError.
+//-----------------------------------------------------------------------------
+int getEqualErrorPrecision( float fMaxError, float r )
+{
+    int nLow  = 2;
+    int nHigh = MAX_LOD_PRECISION/2;
+
+    while( nLow < nHigh )
+    {
+        int   nMid = (nLow + nHigh) / 2;
+        float fMaxEdge;
+
+        if( getUVSphereError( nMid*2, r, &fMaxEdge ) <= fMaxError )
+            nHigh = nMid;
+        else
+            nLow = nMid + 1;
+    }
+
+    return nLow*2;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getTriangleError()
+// Desc: How far inside a sphere of radius r, centred on the origin, the
+//       triangle abc with its corners on the sphere gets. The plane's
+//       closest point to the centre is the circumcentre, which is only on
+//       the triangle when no angle is obtuse. Otherwise the closest point
+//       is the middle of the longest edge. Also keeps the longest edge.
+//-----------------------------------------------------------------------------
+double getTriangleError( const double *a, const double *b, const double *c, double r,
+                        double *pdMaxEdge )
+{
+    double ab[3], ac[3], bc[3];
+
+    for( int k = 0; k < 3; ++k )
+    {
+        ab[k] = b[k] - a[k];
+        ac[k] = c[k] - a[k];
+        bc[k] = c[k] - b[k];
+    }
+
+    double dAB = ab[0]*ab[0] + ab[1]*ab[1] + ab[2]*ab[2];
+    double dAC = ac[0]*ac[0] + ac[1]*ac[1] + ac[2]*ac[2];
+    double dBC = bc[0]*bc[0] + bc[1]*bc[1] + bc[2]*bc[2];
+    double dLongest = max( dAB, max( dAC, dBC ) );
+
+    *pdMaxEdge = max( *pdMaxEdge, sqrt( dLongest ) );
+
+    double normal[3] = { ab[1]*ac[2] - ab[2]*ac[1],
+                         ab[2]*ac[0] - ab[0]*ac[2],
+                         ab[0]*ac[1] - ab[1]*ac[0] };
+
+    double dArea = sqrt( normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2] );
+
+    // The triangles where a strip meets a pole have no area
+    if( dArea < 1e-12 * dLongest )
+        return 0.0;
+
+    bool bAcute = (ab[0]*ac[0] + ab[1]*ac[1] + ab[2]*ac[2]) >= 0.0 &&
+                  (ab[0]*bc[0] + ab[1]*bc[1] + ab[2]*bc[2]) <= 0.0 &&
+                  (ac[0]*bc[0] + ac[1]*bc[1] + ac[2]*bc[2]) >= 0.0;
+
+    if( bAcute )
+        return r - fabs( normal[0]*a[0] + normal[1]*a[1] + normal[2]*a[2] ) / dArea;
+
+    return r - sqrt( max( r*r - dLongest / 4.0, 0.0 ) );
+}
+
+//-----------------------------------------------------------------------------
+// Name: rebuildSphere()
+// Desc: Makes sure the current render mode has what it draws the sphere 
+//       from. The sphere for the current settings is taken from the mesh 
+//       cache when it's there, and only the representations it's missing 
+//       are built.
+//-----------------------------------------------------------------------------
+void rebuildSphere( void )
+{
+    bool   bSwitching = (g_nCurrentMode != g_nRebuildMode);
+    size_t nRSSBefore = bSwitching ? getResidentBytes() : 0;
+
+    // Whatever the builder thread was working on goes to the cache, where
+    // the lookup below can still find it
+    updateSphereBuilder( true );
+
+    uint64_t nStart = getTimeNanoseconds();
+
+    // The modes without a mesh hand the current one to the cache
+    if( hasSphereMesh( g_nCurrentMode ) )
+        selectSphereMesh( g_nPrecision, g_fSphereRadius, getSphereMeshLayout( g_nCurrentMode ) );
+    else
+        selectSphereMesh( 0, 0.0f, STRIP_LAYOUT );
+
+    completeSphereMesh();
+
+    g_fSphereBuildTime = (getTimeNanoseconds() - nStart) / 1000000.0f;
+
+    if( bSwitching )
+    {
+        g_nSwitchedFromMode = g_nRebuildMode;
+        g_nRebuildMode      = g_nCurrentMode;
+        g_nRSSBeforeSwitch  = nRSSBefore;
+        g_nRSSAfterSwitch   = getResidentBytes();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: getMemoryFootprint()
+// Desc: Fills in what the current sphere holds on to, by representation,
+//       and how much of that the current mode draws from. Client arrays are
+//       counted from their sizes, a display list as one float vertex per
+//       vertex it was compiled from, since the driver won't say, and buffer
+//       objects and the texture, all its mipmaps included, as the driver
+//       sized them.
+//-----------------------------------------------------------------------------
+void getMemoryFootprint( BenchmarkResult *pResult )
+{
+    size_t nFloatBytes   = g_pSphereVertices ? (size_t)g_nNumSphereVertices * sizeof(Vertex) : 0;
+    size_t nPackedBytes  = g_pPackedVertices ? (size_t)g_nNumSphereVertices * getVertexFormatSize( g_nPackedFormat ) : 0;
+    size_t nIndexBytes   = g_pSphereIndices ? (size_t)g_nNumSphereIndices * getIndexSize() : 0;
+    size_t nTNLBytes     = (size_t)g_nMaxTransformedVertices * TRANSFORMED_VERTEX_FLOATS * sizeof(GLfloat);
+    size_t nDListBytes   = g_sphereDList ? (size_t)g_nNumSphereVertices * sizeof(Vertex) : 0;
+    size_t nSphereBytes  = getBufferObjectBytes( g_sphereVBO ) + getBufferObjectBytes( g_sphereIBO );
+    size_t nStreamBytes  = 0;
+
+    for( int i = 0; i < NUM_STREAM_BUFFERS; ++i )
+        nStreamBytes += getBufferObjectBytes( g_streamVBOs[i] );
+
+    pResult->nClientArrayBytes  = nFloatBytes + nPackedBytes + nIndexBytes + nTNLBytes;
+    pResult->nDisplayListBytes  = nDListBytes;
+    pResult->nBufferObjectBytes = nSphereBytes + nStreamBytes + getBufferObjectBytes( g_instanceVBO );
+    pResult->nTextureBytes      = getTextureBytes();
+
+    switch( g_nCurrentMode )
+    {
+        case IMMEDIATE_MODE: pResult->nModeBytes = nFloatBytes + nIndexBytes; break;
+        case DISPLAY_LIST:   pResult->nModeBytes = nDListBytes; break;
+        case VERTEX_BUFFER:  pResult->nModeBytes = nSphereBytes; break;
+        case STREAMING_MODE: pResult->nModeBytes = nStreamBytes; break;
+        case SOFTWARE_TNL:   pResult->nModeBytes = nFloatBytes + nIndexBytes + nTNLBytes; break;
+
+        case VERTEX_ARRAY:
+            pResult->nModeBytes = (g_nPackedFormat != FLOAT_FORMAT ? nPackedBytes : nFloatBytes) + nIndexBytes;
+            break;
+
+        // The procedural and impostor modes have no vertex data anywhere
+        default: pResult->nModeBytes = 0; break;
+    }
+
+    pResult->nSwitchedFromMode = g_nSwitchedFromMode;
+    pResult->nRSSBeforeSwitch  = g_nRSSBeforeSwitch;
+    pResult->nRSSAfterSwitch   = g_nRSSAfterSwitch;
+    pResult->nResidentBytes    = getResidentBytes();
+}
+
+//-----------------------------------------------------------------------------
+// Name: getBufferObjectBytes()
+// Desc: Size of a buffer object's store, 0 if it hasn't been created.
+//-----------------------------------------------------------------------------
+size_t getBufferObjectBytes( GLuint buffer )
+{
+    if( buffer == 0 )
+        return 0;
+
+    GLint nSize = 0;
+
+    glBindBuffer( GL_ARRAY_BUFFER, buffer );
+    glGetBufferParameteriv( GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &nSize );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    return nSize;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getTextureBytes()
+// Desc: Adds up every level of the sphere texture at the bits per texel the
+//       driver says it keeps, which may be less than it really uses if it
+//       pads RGB out to RGBA.
+//-----------------------------------------------------------------------------
+size_t getTextureBytes( void )
+{
+    size_t nBytes = 0;
+
+    glBindTexture( GL_TEXTURE_2D, g_textureID );
+
+    for( int nLevel = 0; ; ++nLevel )
+    {
+        GLint nWidth  = 0;
+        GLint nHeight = 0;
+        GLint anBits[4] = { 0, 0, 0, 0 };
+
+        glGetTexLevelParameteriv( GL_TEXTURE_2D, nLevel, GL_TEXTURE_WIDTH, &nWidth );
+        glGetTexLevelParameteriv( GL_TEXTURE_2D, nLevel, GL_TEXTURE_HEIGHT, &nHeight );
+
+        if( nWidth == 0 || nHeight == 0 )
+            break;
+
+        glGetTexLevelParameteriv( GL_TEXTURE_2D, nLevel, GL_TEXTURE_RED_SIZE, &anBits[0] );
+        glGetTexLevelParameteriv( GL_TEXTURE_2D, nLevel, GL_TEXTURE_GREEN_SIZE, &anBits[1] );
+        glGetTexLevelParameteriv( GL_TEXTURE_2D, nLevel, GL_TEXTURE_BLUE_SIZE, &anBits[2] );
+        glGetTexLevelParameteriv( GL_TEXTURE_2D, nLevel, GL_TEXTURE_ALPHA_SIZE, &anBits[3] );
+
+        nBytes += (size_t)nWidth * nHeight * (anBits[0] + anBits[1] + anBits[2] + anBits[3]) / 8;
+    }
+
+    return nBytes;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getResidentBytes()
+// Desc: The process's resident set size, from /proc. 0 where there's no
+//       /proc to read it from.
+//-----------------------------------------------------------------------------
+size_t getResidentBytes( void )
+{
+    FILE          *pFile = fopen( "/proc/self/statm", "r" );
+    unsigned long  nSize = 0;
+    unsigned long  nResidentPages = 0;
+
+    if( pFile == NULL )
+        return 0;
+
+    if( fscanf( pFile, "%lu %lu", &nSize, &nResidentPages ) != 2 )
+        nResidentPages = 0;
+
+    fclose( pFile );
+
+    return (size_t)nResidentPages * sysconf( _SC_PAGESIZE );
+}
+
+//-----------------------------------------------------------------------------
+// Name: getSphereMeshLayout()
+// Desc: Layout of the mesh a render mode draws from. The display list is 
+//       always compiled from strips, whatever the layout.
+//-----------------------------------------------------------------------------
+GLuint getSphereMeshLayout( GLuint nMode )
+{
+    return (nMode == DISPLAY_LIST) ? STRIP_LAYOUT : g_nSphereLayout;
+}
+
+//-----------------------------------------------------------------------------
+// Name: completeSphereMesh()
+// Desc: Builds whatever the current render mode needs that the current 
+//       sphere doesn't have yet.
+//-----------------------------------------------------------------------------
+void completeSphereMesh( void )
+{
+    if( g_nCurrentMode == DISPLAY_LIST && g_sphereDList == 0 )
+        createSphereDisplayList();
+
+    if( (g_nCurrentMode == IMMEDIATE_MODE || 
+         g_nCurrentMode == VERTEX_ARRAY   ||
+         g_nCurrentMode == VERTEX_BUFFER  ||
+         g_nCurrentMode == SOFTWARE_TNL) && g_pSphereVertices == NULL )
+    {
+        createSphereGeometry( 0.0f, 0.0f, 0.0f, g_fMeshRadius, g_nMeshPrecision );
+    }
+
+    // Immediate mode always feeds the floats to glVertex3f() and friends
+    if( g_nCurrentMode == VERTEX_ARRAY && g_nPackedFormat != g_nVertexFormat )
+        packSphereVertices();
+
+    if( g_nCurrentMode == VERTEX_BUFFER && 
+        (g_sphereVBO == 0 || g_nBufferFormat != g_nVertexFormat) )
+    {
+        createSphereBuffer();
+    }
+
+    if( g_nCurrentMode == STREAMING_MODE )
+        createSphereStream();
+
+    if( g_nCurrentMode == PROCEDURAL )
+        createSphereProcedural();
+
+    if( g_nCurrentMode == IMPOSTOR_MODE )
+        createSphereImpostor();
+
+    if( g_nCurrentMode == SOFTWARE_TNL )
+        createSphereSoftware();
+
+    if( g_bBandCulling && canCullBands() && g_nCullPrecision != g_nMeshPrecision )
+        createCullCones();
+
+    if( canDrawBandStrips() && g_nBandStripPrecision != g_nMeshPrecision )
+        createBandStrips();
+}
+
+//-----------------------------------------------------------------------------
+// Name: hasSphereMesh()
+// Desc: Streaming regenerates the sphere as it draws it, and the procedural 
+//       and impostor modes make it up on the GPU, so none of them draw from 
+//       a mesh.
+//-----------------------------------------------------------------------------
+bool hasSphereMesh( GLuint nMode )
+{
+    return nMode != STREAMING_MODE && nMode != PROCEDURAL && nMode != IMPOSTOR_MODE;
+}
+
+//-----------------------------------------------------------------------------
+// Name: rebuildSphereInBackground()
+// Desc: Like rebuildSphere(), but when the sphere has to be generated from 
+//       scratch it's done on the builder thread, and the current sphere is 
+//       drawn until it's ready.
+//-----------------------------------------------------------------------------
+void rebuildSphereInBackground( void )
+{
+    // Nothing to keep drawing in the meantime without a mesh
+    if( !g_bBackgroundRebuild || !hasSphereMesh( g_nCurrentMode ) )
+    {
+        rebuildSphere();
+        return;
+    }
+
+    // updateSphereBuilder() starts another build if the precision has moved
+    // on by the time this one is done
+    if( g_bBuilderRunning )
+        return;
+
+    // Nothing worth waiting for if the cache has it
+    if( isSphereMeshCached( g_nPrecision, g_fSphereRadius, getSphereMeshLayout( g_nCurrentMode ) ) )
+    {
+        rebuildSphere();
+        return;
+    }
+
+    startSphereBuilder();
+}
+
+//-----------------------------------------------------------------------------
+// Name: isSphereMeshCached()
+// Desc: True if the sphere is either the current one or in the mesh cache.
+//-----------------------------------------------------------------------------
+bool isSphereMeshCached( GLuint nPrecision, float fRadius, GLuint nLayout )
+{
+    if( g_nMeshPrecision == nPrecision && g_fMeshRadius == fRadius && 
+        g_nMeshLayout == nLayout )
+        return true;
+
+    for( int i = 0; i < g_nNumCachedMeshes; ++i )
+    {
+        if( g_meshCache[i].nPrecision == nPrecision && 
+            g_meshCache[i].fRadius    == fRadius    &&
+            g_meshCache[i].nLayout    == nLayout )
+            return true;
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name: startSphereBuilder()
+// Desc: Starts generating the client arrays of the sphere for the current 
+//       settings on the builder thread.
+//-----------------------------------------------------------------------------
+void startSphereBuilder( void )
+{
+    g_builderMesh.nPrecision    = g_nPrecision;
+    g_builderMesh.fRadius       = g_fSphereRadius;
+    g_builderMesh.nLayout       = getSphereMeshLayout( g_nCurrentMode );
+    g_builderMesh.dList         = 0;
+    g_builderMesh.vbo           = 0;
+    g_builderMesh.ibo           = 0;
+    g_builderMesh.nBufferFormat = FLOAT_FORMAT;
+
+    // Immediate mode and the display list only need the floats
+    if( g_nCurrentMode == VERTEX_ARRAY || g_nCurrentMode == VERTEX_BUFFER )
+        g_nBuilderFormat = g_nVertexFormat;
+    else
+        g_nBuilderFormat = FLOAT_FORMAT;
+
+    g_nBuilderDone = 0;
+
+    if( pthread_create( &g_builderThread, NULL, sphereBuilderMain, NULL ) != 0 )
+    {
+        cerr << "ERROR: startSphereBuilder - Couldn't start the builder thread." << endl;
+        rebuildSphere();
+        return;
+    }
+
+    g_bBuilderRunning = true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: sphereBuilderMain()
+// Desc: The builder thread. Only ever touches g_builderMesh, and there's no 
+//       OpenGL context on this thread, so the display list and the buffer 
+//       objects are left to updateSphereBuilder().
+//-----------------------------------------------------------------------------
+void *sphereBuilderMain( void * /*pArg*/ )
+{
+    uint64_t nStart = getTimeNanoseconds();
+
+    loadSphereMesh( &g_builderMesh, 0.0f, 0.0f, 0.0f, g_builderMesh.fRadius, 
+                    g_builderMesh.nPrecision, g_builderMesh.nLayout );
+
+    if( g_nBuilderFormat != FLOAT_FORMAT )
+        packSphereMesh( &g_builderMesh, g_nBuilderFormat );
+
+    g_fBuilderTime = (getTimeNanoseconds() - nStart) / 1000000.0f;
+
+    // Publishes everything written above to the main thread
+    __sync_lock_test_and_set( &g_nBuilderDone, 1 );
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: updateSphereBuilder()
+// Desc: Called between frames. Once the builder thread is done, its sphere 
+//       becomes the current one and gets whatever OpenGL objects the render
+//       mode needs. With bWait, waits for the builder instead and puts its 
+//       sphere in the mesh cache, since the settings are about to change.
+//-----------------------------------------------------------------------------
+void updateSphereBuilder( bool bWait )
+{
+    if( !g_bBuilderRunning )
+        return;
+
+    if( !bWait && __sync_fetch_and_add( &g_nBuilderDone, 0 ) == 0 )
+        return;
+
+    pthread_join( g_builderThread, NULL );
+    g_bBuilderRunning = false;
+
+    // The cache clock belongs to this thread, so the builder's sphere is
+    // stamped here, as it's handed over
+    g_builderMesh.nLastUsed = ++g_nMeshCacheClock;
+
+    if( bWait )
+    {
+        cacheSphereMesh( &g_builderMesh );
+        return;
+    }
+
+    uint64_t nStart = getTimeNanoseconds();
+
+    selectSphereMesh( g_builderMesh.nPrecision, g_builderMesh.fRadius, g_builderMesh.nLayout );
+
+    if( g_pSphereVertices == NULL )
+        setSphereArrays( &g_builderMesh );
+    else
+        freeSphereMesh( &g_builderMesh );
+
+    completeSphereMesh();
+
+    float fSwapTime = (getTimeNanoseconds() - nStart) / 1000000.0f;
+
+    g_fSphereBuildTime = g_fBuilderTime + fSwapTime;
+
+    if( !g_bHeadless )
+        cout << "Sphere Resolution " << g_nMeshPrecision << " swapped in (built in " 
+             << g_fBuilderTime << " ms, " << fSwapTime << " ms on the render thread)" << endl;
+
+    // Catch up with any F1/F2 presses made while this one was being built
+    if( g_nMeshPrecision != g_nPrecision )
+        rebuildSphereInBackground();
+}
+
+//-----------------------------------------------------------------------------
+// Name: selectSphereMesh()
+// Desc: Makes the sphere with the given key the current one. The old current
+//       sphere goes into the mesh cache, and the new one is taken out of it 
+//       if it's there, or starts out empty otherwise. A precision of 0 just 
+//       puts the current sphere away.
+//-----------------------------------------------------------------------------
+void selectSphereMesh( GLuint nPrecision, float fRadius, GLuint nLayout )
+{
+    if( g_nMeshPrecision == nPrecision && g_fMeshRadius == fRadius && 
+        g_nMeshLayout == nLayout )
+        return;
+
+    SphereMesh mesh;
+    detachSphereMesh( &mesh );
+    cacheSphereMesh( &mesh );
+
+    if( nPrecision == 0 )
+        return;
+
+    if( findCachedMesh( nPrecision, fRadius, nLayout, &mesh ) )
+    {
+        attachSphereMesh( &mesh );
+        ++g_nMeshCacheHits;
+        return;
+    }
+
+    ++g_nMeshCacheMisses;
+
+    g_nMeshPrecision = nPrecision;
+    g_fMeshRadius    = fRadius;
+    g_nMeshLayout    = nLayout;
+}
+
+//-----------------------------------------------------------------------------
+// Name: detachSphereMesh()
+// Desc: Moves the current sphere into pMesh, leaving no current sphere.
+//-----------------------------------------------------------------------------
+void detachSphereMesh( SphereMesh *pMesh )
+{
+    pMesh->nPrecision           = g_nMeshPrecision;
+    pMesh->fRadius              = g_fMeshRadius;
+    pMesh->nLayout              = g_nMeshLayout;
+    pMesh->pVertices            = g_pSphereVertices;
+    pMesh->nNumVertices         = g_nNumSphereVertices;
+    pMesh->pPackedVertices      = g_pPackedVertices;
+    pMesh->nPackedFormat        = g_nPackedFormat;
+    pMesh->fPackedPositionScale = g_fPackedPositionScale;
+    pMesh->pIndices             = g_pSphereIndices;
+    pMesh->indexType            = g_sphereIndexType;
+    pMesh->indexPrimitive       = g_sphereIndexPrimitive;
+    pMesh->nNumIndices          = g_nNumSphereIndices;
+    pMesh->fACMR                = g_fSphereACMR;
+    pMesh->fATVR                = g_fSphereATVR;
+    pMesh->pMeshFile            = g_pMeshFile;
+    pMesh->nMeshFileBytes       = g_nMeshFileBytes;
+    pMesh->dList                = g_sphereDList;
+    pMesh->vbo                  = g_sphereVBO;
+    pMesh->ibo                  = g_sphereIBO;
+    pMesh->nBufferFormat        = g_nBufferFormat;
+    pMesh->nLastUsed            = ++g_nMeshCacheClock;
+
+    g_nMeshPrecision     = 0;
+    g_pSphereVertices    = NULL;
+    g_nNumSphereVertices = 0;
+    g_pPackedVertices    = NULL;
+    g_nPackedFormat      = FLOAT_FORMAT;
+    g_pSphereIndices     = NULL;
+    g_nNumSphereIndices  = 0;
+    g_pMeshFile          = NULL;
+    g_nMeshFileBytes     = 0;
+    g_sphereDList        = 0;
+    g_sphereVBO          = 0;
+    g_sphereIBO          = 0;
+    g_nBufferFormat      = FLOAT_FORMAT;
+}
+
+//-----------------------------------------------------------------------------
+// Name: attachSphereMesh()
+// Desc: Makes pMesh the current sphere. The current one must be detached.
+//-----------------------------------------------------------------------------
+void attachSphereMesh( const SphereMesh *pMesh )
+{
+    g_nMeshPrecision       = pMesh->nPrecision;
+    g_fMeshRadius          = pMesh->fRadius;
+    g_nMeshLayout          = pMesh->nLayout;
+    g_pSphereVertices      = pMesh->pVertices;
+    g_nNumSphereVertices   = pMesh->nNumVertices;
+    g_pPackedVertices      = pMesh->pPackedVertices;
+    g_nPackedFormat        = pMesh->nPackedFormat;
+    g_fPackedPositionScale = pMesh->fPackedPositionScale;
+    g_pSphereIndices       = pMesh->pIndices;
+    g_sphereIndexType      = pMesh->indexType;
+    g_sphereIndexPrimitive = pMesh->indexPrimitive;
+    g_nNumSphereIndices    = pMesh->nNumIndices;
+    g_fSphereACMR          = pMesh->fACMR;
+    g_fSphereATVR          = pMesh->fATVR;
+    g_pMeshFile            = pMesh->pMeshFile;
+    g_nMeshFileBytes       = pMesh->nMeshFileBytes;
+    g_sphereDList          = pMesh->dList;
+    g_sphereVBO            = pMesh->vbo;
+    g_sphereIBO            = pMesh->ibo;
+    g_nBufferFormat        = pMesh->nBufferFormat;
+}
+
+//-----------------------------------------------------------------------------
+// Name: freeSphereMesh()
+// Desc: Releases the arrays and OpenGL objects of a detached sphere.
+//-----------------------------------------------------------------------------
+void freeSphereMesh( SphereMesh *pMesh )
+{
+    if( pMesh->pMeshFile != NULL )
+        unmapMeshFile( pMesh->pMeshFile, pMesh->nMeshFileBytes );
+    else
+    {
+        delete []pMesh->pVertices;
+        free( pMesh->pIndices );
+    }
+
+    free( pMesh->pPackedVertices );
+
+    if( pMesh->dList != 0 )
+        glDeleteLists( pMesh->dList, 1 );
+
+    if( pMesh->vbo != 0 )
+        glDeleteBuffers( 1, &pMesh->vbo );
+
+    if( pMesh->ibo != 0 )
+        glDeleteBuffers( 1, &pMesh->ibo );
+
+    pMesh->nPrecision      = 0;
+    pMesh->pVertices       = NULL;
+    pMesh->pPackedVertices = NULL;
+    pMesh->pIndices        = NULL;
+    pMesh->pMeshFile       = NULL;
+    pMesh->nMeshFileBytes  = 0;
+    pMesh->dList           = 0;
+    pMesh->vbo             = 0;
+    pMesh->ibo             = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getSphereMeshBytes()
+// Desc: Memory a sphere holds on to, in the client and in the driver. A 
+//       display list is counted as one float vertex per vertex it was 
+//       compiled from.
+//-----------------------------------------------------------------------------
+size_t getSphereMeshBytes( const SphereMesh *pMesh )
+{
+    size_t nIndexSize = (pMesh->indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+    size_t nBytes     = 0;
+
+    if( pMesh->pVertices != NULL )
+        nBytes += (size_t)pMesh->nNumVertices * sizeof(Vertex);
+
+    if( pMesh->pPackedVertices != NULL )
+        nBytes += (size_t)pMesh->nNumVertices * getVertexFormatSize( pMesh->nPackedFormat );
+
+    if( pMesh->pIndices != NULL )
+        nBytes += (size_t)pMesh->nNumIndices * nIndexSize;
+
+    if( pMesh->dList != 0 )
+        nBytes += (size_t)pMesh->nNumVertices * sizeof(Vertex);
+
+    if( pMesh->vbo != 0 )
+        nBytes += (size_t)pMesh->nNumVertices * getVertexFormatSize( pMesh->nBufferFormat );
+
+    if( pMesh->ibo != 0 )
+        nBytes += (size_t)pMesh->nNumIndices * nIndexSize;
+
+    return nBytes;
+}
+
+//-----------------------------------------------------------------------------
+// Name: cacheSphereMesh()
+// Desc: Hands a detached sphere over to the mesh cache, then evicts the 
+//       least recently used spheres until the cache is back within its 
+//       budget. A sphere bigger than the whole budget is freed right away.
+//-----------------------------------------------------------------------------
+void cacheSphereMesh( const SphereMesh *pMesh )
+{
+    if( pMesh->nPrecision == 0 )
+        return;
+
+    if( g_nNumCachedMeshes == MAX_CACHED_MESHES )
+        evictOldestMesh();
+
+    g_meshCache[g_nNumCachedMeshes++] = *pMesh;
+
+    while( g_nNumCachedMeshes > 0 && getMeshCacheBytes() > g_nMeshCacheBudget )
+        evictOldestMesh();
+}
+
+//-----------------------------------------------------------------------------
+// Name: evictOldestMesh()
+// Desc: Frees the least recently used sphere in the mesh cache.
+//-----------------------------------------------------------------------------
+void evictOldestMesh( void )
+{
+    int nOldest = 0;
+
+    for( int i = 1; i < g_nNumCachedMeshes; ++i )
+    {
+        if( g_meshCache[i].nLastUsed < g_meshCache[nOldest].nLastUsed )
+            nOldest = i;
+    }
+
+    freeSphereMesh( &g_meshCache[nOldest] );
+    g_meshCache[nOldest] = g_meshCache[--g_nNumCachedMeshes];
+}
+
+//-----------------------------------------------------------------------------
+// Name: findCachedMesh()
+// Desc: Takes the sphere with the given key out of the mesh cache. Returns 
+//       false if it isn't there.
+//-----------------------------------------------------------------------------
+bool findCachedMesh( GLuint nPrecision, float fRadius, GLuint nLayout, SphereMesh *pMesh )
+{
+    for( int i = 0; i < g_nNumCachedMeshes; ++i )
+    {
+        if( g_meshCache[i].nPrecision == nPrecision && 
+            g_meshCache[i].fRadius    == fRadius    &&
+            g_meshCache[i].nLayout    == nLayout )
+        {
+            *pMesh         = g_meshCache[i];
+            g_meshCache[i] = g_meshCache[--g_nNumCachedMeshes];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getMeshCacheBytes()
+// Desc: Memory held by all the cached spheres.
+//-----------------------------------------------------------------------------
+size_t getMeshCacheBytes( void )
+{
+    size_t nBytes = 0;
+
+    for( int i = 0; i < g_nNumCachedMeshes; ++i )
+        nBytes += getSphereMeshBytes( &g_meshCache[i] );
+
+    return nBytes;
+}
+
+//-----------------------------------------------------------------------------
+// Name: clearMeshCache()
+// Desc: 
+//-----------------------------------------------------------------------------
+void clearMeshCache( void )
+{
+    for( int i = 0; i < g_nNumCachedMeshes; ++i )
+        freeSphereMesh( &g_meshCache[i] );
+
+    g_nNumCachedMeshes = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getRenderModeName()
+// Desc: Human readable name of a render mode, as used in the reports.
+//-----------------------------------------------------------------------------
+const char *getRenderModeName( GLuint nMode )
+{
+    switch( nMode )
+    {
+        case IMMEDIATE_MODE: return "Immediate Mode";
+        case DISPLAY_LIST:   return "Display List";
+        case VERTEX_ARRAY:   return "Vertex Array";
+        case VERTEX_BUFFER:  return "Vertex Buffer Object";
+        case STREAMING_MODE: return "Streaming";
+        case PROCEDURAL:     return "Procedural";
+        case IMPOSTOR_MODE:  return "Impostor";
+        case SOFTWARE_TNL:   return "Software T&L";
+    }
+
+    return "Unknown";
+}
+
+//-----------------------------------------------------------------------------
+// Name: getRenderModeKey()
+// Desc: Short name of a render mode, as used on the command line and in JSON.
+//-----------------------------------------------------------------------------
+const char *getRenderModeKey( GLuint nMode )
+{
+    switch( nMode )
+    {
+        case IMMEDIATE_MODE: return "immediate";
+        case DISPLAY_LIST:   return "display_list";
+        case VERTEX_ARRAY:   return "vertex_array";
+        case VERTEX_BUFFER:  return "vertex_buffer";
+        case STREAMING_MODE: return "streaming";
+        case PROCEDURAL:     return "procedural";
+        case IMPOSTOR_MODE:  return "impostor";
+        case SOFTWARE_TNL:   return "software_tnl";
+    }
+
+    return "unknown";
+}
+
+//-----------------------------------------------------------------------------
+// Name: getLayoutName()
+// Desc: 
+//-----------------------------------------------------------------------------
+const char *getLayoutName( GLuint nLayout )
+{
+    switch( nLayout )
+    {
+        case STRIP_LAYOUT:     return "Triangle Strip";
+        case INDEXED_LAYOUT:   return "Indexed Triangle Strip";
+        case OPTIMIZED_LAYOUT: return "Cache-Optimized Indexed Triangles";
+        case ICOSPHERE_LAYOUT: return "Subdivided Icosahedron";
+    }
+
+    return "Unknown";
+}
+
+//-----------------------------------------------------------------------------
+// Name: getLayoutKey()
+// Desc: 
+//-----------------------------------------------------------------------------
+const char *getLayoutKey( GLuint nLayout )
+{
+    switch( nLayout )
+    {
+        case STRIP_LAYOUT:     return "strip";
+        case INDEXED_LAYOUT:   return "indexed";
+        case OPTIMIZED_LAYOUT: return "optimized";
+        case ICOSPHERE_LAYOUT: return "icosphere";
+    }
+
+    return "unknown";
+}
+
+//-----------------------------------------------------------------------------
+// Name: getVertexFormatName()
+// Desc: 
+//-----------------------------------------------------------------------------
+const char *getVertexFormatName( GLuint nFormat )
+{
+    switch( nFormat )
+    {
+        case FLOAT_FORMAT: return "GL_T2F_N3F_V3F";
+        case HALF_FORMAT:  return "Half Tex Coords, Byte Normals, Float Positions";
+        case SHORT_FORMAT: return "Short Tex Coords, Byte Normals, Short Positions";
+    }
+
+    return "Unknown";
+}
+
+//-----------------------------------------------------------------------------
+// Name: getVertexFormatKey()
+// Desc: 
+//-----------------------------------------------------------------------------
+const char *getVertexFormatKey( GLuint nFormat )
+{
+    switch( nFormat )
+    {
+        case FLOAT_FORMAT: return "float";
+        case HALF_FORMAT:  return "half";
+        case SHORT_FORMAT: return "short";
+    }
+
+    return "unknown";
+}
+
+//-----------------------------------------------------------------------------
+// Name: doBenchmark()
+// Desc: 
+//-----------------------------------------------------------------------------
+void doBenchmark()
+{
+    BenchmarkResult result;
+
+    // Benchmark the sphere that was asked for, not the one it's replacing
+    if( g_bBuilderRunning )
+        rebuildSphere();
+
+    runBenchmark( &result );
+    printBenchmarkReport( &result );
+}
+
+//-----------------------------------------------------------------------------
+// Name: getTimeNanoseconds()
+// Desc: Reads the monotonic clock, which ntp and the user can't step.
+//-----------------------------------------------------------------------------
+uint64_t getTimeNanoseconds( void )
+{
+    timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getPercentile()
+// Desc: Nearest-rank percentile of an already sorted array.
+//-----------------------------------------------------------------------------
+float getPercentile( const float *pSorted, int nCount, float fPercent )
+{
+    int nRank = (int)ceilf( fPercent / 100.0f * nCount );
+
+    if( nRank < 1 )
+        nRank = 1;
+
+    if( nRank > nCount )
+        nRank = nCount;
+
+    return pSorted[nRank - 1];
+}
+
+//-----------------------------------------------------------------------------
+// Name: runBenchmark()
+// Desc: Times g_nBenchmarkFrames calls to render() with the current settings,
+//       after g_nWarmUpFrames untimed ones. Every frame is fenced with 
+//       glFinish() so its time covers the GPU work and not just submission.
+//-----------------------------------------------------------------------------
+void runBenchmark( BenchmarkResult *pResult )
+{
+    int    nFrames         = g_nBenchmarkFrames;
+    float *pFrameTimes     = new float[nFrames];
+    float *pSubmitTimes    = new float[nFrames];
+    float *pSwapTimes      = new float[nFrames];
+    float *pGPUTimes       = new float[nFrames];
+    float *pTransformTimes = new float[nFrames];
+    double dTotal          = 0.0;
+
+    // Let the driver settle on the current geometry before timing anything
+    for( int i = 0; i < g_nWarmUpFrames; ++i )
+        render();
+
+    glFinish();
+
+    // The warm-up frames' queries don't count
+    finishFrameTimers();
+
+    g_pGPUFrameTimes     = pGPUTimes;
+    g_nNumGPUFrameTimes  = 0;
+    g_nMaxGPUFrameTimes  = nFrames;
+    g_nLateTimerQueries  = 0;
+
+    g_nCulledVertices    = 0;
+    g_nSubmittedVertices = 0;
+
+    for( int i = 0; i < nFrames; ++i ) // Loop away
+    {
+        uint64_t nStart = getTimeNanoseconds();
+
+        // With the adaptive LOD on, the frame times are those of whatever 
+        // precision it settles on, rebuilds included
+        if( g_bAdaptiveLOD )
+            updateSphereBuilder( false );
+
+        render();
+        glFinish();
+
+        pFrameTimes[i]  = (getTimeNanoseconds() - nStart) / 1000000.0f;
+        pSubmitTimes[i] = g_fSubmitTime;
+        pSwapTimes[i]   = g_fSwapTime;
+        pTransformTimes[i] = g_fTransformTime;
+        dTotal += pFrameTimes[i];
+
+        updateLODController( pFrameTimes[i] );
+    }
+
+    // The last few frames' queries are still in flight
+    finishFrameTimers();
+
+    int nGPUFrames = g_nNumGPUFrameTimes;
+
+    g_pGPUFrameTimes = NULL;
+
+    // Report the sphere the adaptive LOD ended up on
+    if( g_bBuilderRunning )
+        rebuildSphere();
+
+    double dMean     = dTotal / nFrames;
+    double dVariance = 0.0;
+
+    for( int i = 0; i < nFrames; ++i )
+        dVariance += (pFrameTimes[i] - dMean) * (pFrameTimes[i] - dMean);
+
+    dVariance /= nFrames;
+
+    sort( pFrameTimes, pFrameTimes + nFrames );
+
+    pResult->nMode            = g_nCurrentMode;
+    pResult->nPrecision       = g_nPrecision;
+    pResult->nFrames          = nFrames;
+    pResult->nWarmUpFrames    = g_nWarmUpFrames;
+    pResult->fElapsed         = (float)(dTotal / 1000.0);
+    pResult->fFramesPerSecond = (float)(nFrames / (dTotal / 1000.0));
+
+    pResult->nCacheSize       = g_nVertexCacheSize;
+    pResult->nSphereKernel    = g_nSphereKernel;
+    pResult->fBuildTime       = g_fSphereBuildTime;
+    pResult->nNumCachedMeshes = g_nNumCachedMeshes;
+    pResult->nMeshCacheBytes  = getMeshCacheBytes();
+    pResult->nMeshCacheBudget = g_nMeshCacheBudget;
+    pResult->nMeshCacheHits   = g_nMeshCacheHits;
+    pResult->nMeshCacheMisses = g_nMeshCacheMisses;
+
+    pResult->fStartupTime      = g_fStartupTime;
+    pResult->nMeshFilesLoaded  = g_nMeshFilesLoaded;
+    pResult->nMeshFilesWritten = g_nMeshFilesWritten;
+
+    if( g_bGenerationScaling )
+        measureGenerationScaling( pResult );
+    else
+        pResult->nNumGenerationThreads = 0;
+
+    // Only the array modes draw from the packed vertices
+    if( g_nCurrentMode == VERTEX_ARRAY || g_nCurrentMode == VERTEX_BUFFER )
+        pResult->nVertexFormat = g_nVertexFormat;
+    else
+        pResult->nVertexFormat = FLOAT_FORMAT;
+
+    pResult->nBytesPerVertex = getVertexFormatSize( pResult->nVertexFormat );
+
+    if( g_nCurrentMode == STREAMING_MODE )
+    {
+        pResult->nLayout       = STRIP_LAYOUT;
+        pResult->nNumVertices  = g_nNumSphereVertices;
+        pResult->nNumIndices   = 0;
+        pResult->nVertexBytes  = NUM_STREAM_BUFFERS * g_nStreamChunkBands * g_streamTables.nNumColumns*2 * sizeof(Vertex);
+        pResult->nIndexBytes   = 0;
+        pResult->nNumTriangles = g_nNumSphereVertices - 2*g_nStreamChunks;
+        pResult->fACMR         = g_fSphereACMR;
+        pResult->fATVR         = g_fSphereATVR;
+    }
+    else if( g_nCurrentMode == PROCEDURAL || g_nCurrentMode == IMPOSTOR_MODE )
+    {
+        pResult->nLayout         = STRIP_LAYOUT;
+        pResult->nBytesPerVertex = 0;
+        pResult->nNumVertices    = g_nNumSphereVertices;
+        pResult->nNumIndices     = 0;
+        pResult->nVertexBytes    = 0;
+        pResult->nIndexBytes     = 0;
+        pResult->nNumTriangles   = g_nNumSphereVertices - 2;
+        pResult->fACMR           = g_fSphereACMR;
+        pResult->fATVR           = g_fSphereATVR;
+    }
+    else if( g_nCurrentMode == DISPLAY_LIST )
+    {
+        // The list holds one strip per band, copied out of the strip array
+        // when there is one and generated by renderSphere() when there isn't,
+        // and keeps no arrays or indices the report could count.
+        pResult->nLayout       = STRIP_LAYOUT;
+        pResult->nNumVertices  = g_nNumSphereVertices;
+        pResult->nNumIndices   = 0;
+        pResult->nVertexBytes  = 0;
+        pResult->nIndexBytes   = 0;
+        pResult->nNumTriangles = g_nNumSphereVertices - 2*(g_nMeshPrecision/2);
+        pResult->fACMR         = g_nNumSphereVertices / (float)pResult->nNumTriangles;
+        pResult->fATVR         = 1.0f;
+    }
+    else
+    {
+        pResult->nLayout      = g_nSphereLayout;
+        pResult->nNumVertices = g_nNumSphereVertices;
+        pResult->nNumIndices  = g_nNumSphereIndices;
+        pResult->nVertexBytes = (size_t)g_nNumSphereVertices * pResult->nBytesPerVertex;
+        pResult->nIndexBytes  = (size_t)g_nNumSphereIndices * getIndexSize();
+        pResult->fACMR        = g_fSphereACMR;
+        pResult->fATVR        = g_fSphereATVR;
+
+        // Every element of a strip past the first two adds a triangle, and
+        // per-band strips leave out the two that join each band to the next
+        if( g_nSphereLayout == STRIP_LAYOUT && canDrawBandStrips() )
+            pResult->nNumTriangles = g_nNumSphereVertices - 2*(g_nBandStripPrecision/2);
+        else if( g_nSphereLayout == STRIP_LAYOUT )
+            pResult->nNumTriangles = g_nNumSphereVertices - 2;
+        else if( g_sphereIndexPrimitive == GL_TRIANGLE_STRIP )
+            pResult->nNumTriangles = g_nNumSphereIndices - 2;
+        else
+            pResult->nNumTriangles = g_nNumSphereIndices / 3;
+    }
+
+    pResult->nNumSpheres    = g_nNumSpheres;
+    pResult->bInstanced     = g_bInstancedScene && canDrawInstanced();
+    pResult->nDrawsPerFrame = pResult->bInstanced ? 1 : g_nNumSpheres;
+    pResult->fLODTargetTime = g_bAdaptiveLOD ? g_fLODTargetTime : 0.0f;
+    pResult->nLODChanges    = g_nLODChanges;
+    pResult->bBandCulling   = g_bBandCulling && canCullBands();
+    pResult->fCulledFraction = 0.0f;
+
+    if( g_nCulledVertices + g_nSubmittedVertices > 0 )
+        pResult->fCulledFraction = g_nCulledVertices / (float)(g_nCulledVertices + g_nSubmittedVertices);
+
+    pResult->bBandStrips        = canDrawBandStrips();
+    pResult->nStitchTriangles   = 0;
+    pResult->fSingleStripMedian = 0.0f;
+
+    // The impostor is exact, and everything else but the icosphere is the
+    // UV sphere
+    int p = max( (int)g_nPrecision, 4 );
+
+    pResult->fMaxEdge             = 0.0f;
+    pResult->fMaxError            = 0.0f;
+    pResult->nIcosphereFrequency  = 0;
+    pResult->nEqualErrorPrecision = 0;
+    pResult->nEqualErrorVertices  = 0;
+    pResult->fEqualErrorMedian    = 0.0f;
+
+    if( pResult->nLayout == ICOSPHERE_LAYOUT )
+    {
+        pResult->nIcosphereFrequency  = getIcosphereFrequency( p, g_fSphereRadius );
+        pResult->fMaxError            = getIcosphereError( pResult->nIcosphereFrequency,
+                                                           g_fSphereRadius, &pResult->fMaxEdge );
+        pResult->nEqualErrorPrecision = getEqualErrorPrecision( pResult->fMaxError, g_fSphereRadius );
+        pResult->nEqualErrorVertices  = getNumLayoutVertices( OPTIMIZED_LAYOUT,
+                                                              pResult->nEqualErrorPrecision );
+    }
+    else if( g_nCurrentMode != IMPOSTOR_MODE )
+        pResult->fMaxError = getUVSphereError( p, g_fSphereRadius, &pResult->fMaxEdge );
+
+    pResult->fTrianglesPerSecond = (float)pResult->nNumTriangles * pResult->nNumSpheres * 
+                                   pResult->fFramesPerSecond;
+
+    pResult->fMinFrameTime    = pFrameTimes[0];
+    pResult->fMedianFrameTime = getPercentile( pFrameTimes, nFrames, 50.0f );
+    pResult->fP95FrameTime    = getPercentile( pFrameTimes, nFrames, 95.0f );
+    pResult->fP99FrameTime    = getPercentile( pFrameTimes, nFrames, 99.0f );
+    pResult->fMaxFrameTime    = pFrameTimes[nFrames - 1];
+    pResult->fMeanFrameTime   = (float)dMean;
+    pResult->fStdDevFrameTime = (float)sqrt( dVariance );
+
+    sort( pSubmitTimes, pSubmitTimes + nFrames );
+    sort( pSwapTimes, pSwapTimes + nFrames );
+    sort( pGPUTimes, pGPUTimes + nGPUFrames );
+
+    pResult->fSubmitMedian     = getPercentile( pSubmitTimes, nFrames, 50.0f );
+    pResult->fSwapMedian       = getPercentile( pSwapTimes, nFrames, 50.0f );
+    pResult->fGPUMedian        = (nGPUFrames > 0) ? getPercentile( pGPUTimes, nGPUFrames, 50.0f ) : 0.0f;
+    pResult->nGPUFrames        = nGPUFrames;
+    pResult->nLateTimerQueries = g_nLateTimerQueries;
+
+    sort( pTransformTimes, pTransformTimes + nFrames );
+
+    bool bSoftware = (g_nCurrentMode == SOFTWARE_TNL);
+
+    pResult->fTransformMedian       = bSoftware ? getPercentile( pTransformTimes, nFrames, 50.0f ) : 0.0f;
+    pResult->nTransformThreads      = bSoftware ? g_nGenerationThreads : 0;
+    pResult->fDriverTransformMedian = 0.0f;
+
+    pResult->nTextureWidth        = g_nTextureWidth;
+    pResult->nTextureHeight       = g_nTextureHeight;
+    pResult->nTextureStrips       = g_nTextureStrips;
+    pResult->bDirectTextureUpload = g_bDirectTextureUpload;
+    pResult->bMipmaps             = g_bMipmaps;
+    pResult->fTextureUploadTime   = g_fTextureUploadTime;
+    pResult->fMipmapTime          = g_fMipmapTime;
+
+    // Before the comparisons below switch modes
+    getMemoryFootprint( pResult );
+
+    delete []pFrameTimes;
+    delete []pSubmitTimes;
+    delete []pSwapTimes;
+    delete []pGPUTimes;
+    delete []pTransformTimes;
+
+    pResult->fMipmappedMedian = g_bMipmaps ? pResult->fMedianFrameTime : 0.0f;
+    pResult->fBaseLevelMedian = g_bMipmaps ? 0.0f : pResult->fMedianFrameTime;
+
+    // Time the same frames minified the other way, to see what sampling 
+    // the mipmaps saves
+    if( g_bCompareMipmaps )
+    {
+        bool bMipmaps = g_bMipmaps;
+
+        g_bMipmaps = !bMipmaps;
+        setTextureFilter();
+
+        float fOtherFilterMedian = timeMedianFrame( nFrames );
+
+        g_bMipmaps = bMipmaps;
+        setTextureFilter();
+
+        if( bMipmaps )
+            pResult->fBaseLevelMedian = fOtherFilterMedian;
+        else
+            pResult->fMipmappedMedian = fOtherFilterMedian;
+    }
+
+    // Time the same sphere left to the driver's T&L, from a float vertex 
+    // array drawn in one call like the software path
+    if( bSoftware )
+    {
+        GLuint nFormat      = g_nVertexFormat;
+        bool   bBandCulling = g_bBandCulling;
+        bool   bBandStrips  = g_bBandStrips;
+
+        g_nCurrentMode  = VERTEX_ARRAY;
+        g_nVertexFormat = FLOAT_FORMAT;
+        g_bBandCulling  = false;
+        g_bBandStrips   = false;
+        rebuildSphere();
+
+        pResult->fDriverTransformMedian = timeMedianFrame( nFrames );
+
+        g_nCurrentMode  = SOFTWARE_TNL;
+        g_nVertexFormat = nFormat;
+        g_bBandCulling  = bBandCulling;
+        g_bBandStrips   = bBandStrips;
+        rebuildSphere();
+    }
+
+    // Time the same number of frames drawn as the single strip, to see what
+    // leaving the joining triangles out saved
+    if( pResult->bBandStrips )
+    {
+        pResult->nStitchTriangles = 2*(g_nBandStripPrecision/2) - 2;
+
+        g_bBandStrips = false;
+        pResult->fSingleStripMedian = timeMedianFrame( nFrames );
+        g_bBandStrips = true;
+    }
+
+    // Time the UV sphere that's as close to the true sphere as the
+    // icosphere, drawn the same way as indexed triangles
+    if( pResult->nLayout == ICOSPHERE_LAYOUT )
+    {
+        GLuint nPrecision = g_nPrecision;
+
+        g_nPrecision    = pResult->nEqualErrorPrecision;
+        g_nSphereLayout = OPTIMIZED_LAYOUT;
+        rebuildSphere();
+
+        pResult->fEqualErrorMedian = timeMedianFrame( nFrames );
+
+        g_nPrecision    = nPrecision;
+        g_nSphereLayout = ICOSPHERE_LAYOUT;
+        rebuildSphere();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: measureGenerationScaling()
+// Desc: Times generating the current sphere's vertices on 1 up to 
+//       g_nGenerationThreads threads. A scratch array is used so the sphere 
+//       being drawn is left alone, and it's filled once beforehand so page 
+//       faults don't count against the first run.
+//-----------------------------------------------------------------------------
+void measureGenerationScaling( BenchmarkResult *pResult )
+{
+    // The whole point of streaming is to never hold the full sphere, and 
+    // the other modes without a mesh don't generate one on the CPU at all
+    if( !hasSphereMesh( g_nCurrentMode ) )
+    {
+        pResult->nNumGenerationThreads = 0;
+        return;
+    }
+
+    GLuint  nLayout     = (g_nCurrentMode == DISPLAY_LIST) ? STRIP_LAYOUT : g_nSphereLayout;
+
+    // The icosphere isn't built from the ring tables, or on more than one
+    // thread
+    if( nLayout == ICOSPHERE_LAYOUT )
+    {
+        pResult->nNumGenerationThreads = 0;
+        return;
+    }
+
+    int     p           = max( (int)g_nPrecision, 4 );
+    Vertex *pVertices   = new Vertex[getNumLayoutVertices( nLayout, p )];
+    int     nNumThreads = min( g_nGenerationThreads, getThreadPoolSize() );
+
+    generateSphereVertices( pVertices, 0.0f, 0.0f, 0.0f, g_fSphereRadius, p, nLayout, nNumThreads );
+
+    pResult->nNumGenerationThreads = nNumThreads;
+
+    for( int n = 1; n <= nNumThreads; ++n )
+    {
+        // Best of three, to keep the scheduler out of it
+        uint64_t nBest = 0;
+
+        for( int nRun = 0; nRun < 3; ++nRun )
+        {
+            uint64_t nStart = getTimeNanoseconds();
+            generateSphereVertices( pVertices, 0.0f, 0.0f, 0.0f, g_fSphereRadius, p, nLayout, n );
+            uint64_t nTime  = getTimeNanoseconds() - nStart;
+
+            if( nRun == 0 || nTime < nBest )
+                nBest = nTime;
+        }
+
+        pResult->afGenerationTime[n - 1] = nBest / 1000000.0f;
+    }
+
+    delete []pVertices;
+}
+
+//-----------------------------------------------------------------------------
+// Name: printBenchmarkReport()
+// Desc: 
+//-----------------------------------------------------------------------------
+void printBenchmarkReport( const BenchmarkResult *pResult )
+{
+    cout << endl;
+    cout << "-- Benchmark Report --" << endl;
+    cout << "Render Method:     " << getRenderModeName( pResult->nMode ) << endl;
+    cout << "Frames Rendered:   " << pResult->nFrames << endl;
+    cout << "Sphere Resolution: " << pResult->nPrecision << endl;
+    cout << "Primitive Used:    " << (pResult->nLayout == OPTIMIZED_LAYOUT ||
+                                      pResult->nLayout == ICOSPHERE_LAYOUT ?
+                                          "GL_TRIANGLES" : "GL_TRIANGLE_STRIP") << endl;
+    cout << "Vertex Layout:     " << getLayoutName( pResult->nLayout ) << endl;
+    cout << "Triangles:         " << pResult->nNumTriangles << " per sphere" << endl;
+    cout << "Spheres:           " << pResult->nNumSpheres << ", " << pResult->nDrawsPerFrame
+         << (pResult->bInstanced ? " instanced draw" : " separate draws") << " per frame" << endl;
+    if( pResult->fLODTargetTime > 0.0f )
+        cout << "Adaptive LOD:      " << pResult->fLODTargetTime << " ms budget, " 
+             << pResult->nLODChanges << " precision changes" << endl;
+
+    if( pResult->bBandCulling )
+        cout << "Band Culling:      " << pResult->fCulledFraction * 100.0f << "% of the vertices culled" << endl;
+
+    if( pResult->bBandStrips )
+        cout << "Band Strips:       " << pResult->nStitchTriangles << " joining triangles left out, "
+             << pResult->fSingleStripMedian - pResult->fMedianFrameTime << " ms saved against "
+             << pResult->fSingleStripMedian << " ms as one strip" << endl;
+
+    cout << "Geometric Error:   " << pResult->fMaxError << " at most, "
+         << pResult->fMaxEdge << " longest edge" << endl;
+
+    if( pResult->nLayout == ICOSPHERE_LAYOUT )
+        cout << "Icosphere:         frequency " << pResult->nIcosphereFrequency << ", "
+             << pResult->nNumVertices << " vertices at " << 1000.0f / pResult->fMedianFrameTime
+             << " FPS against " << pResult->nEqualErrorVertices << " vertices at "
+             << 1000.0f / pResult->fEqualErrorMedian << " FPS for the UV sphere of precision "
+             << pResult->nEqualErrorPrecision << endl;
+
+    cout << "Vertex Format:     " << getVertexFormatName( pResult->nVertexFormat ) << endl;
+    cout << "Bytes Per Vertex:  " << pResult->nBytesPerVertex << endl;
+    cout << "Vertices:          " << pResult->nNumVertices << endl;
+    cout << "Indices:           " << pResult->nNumIndices << endl;
+    cout << "Vertex Memory:     " << pResult->nVertexBytes << " bytes" << endl;
+    cout << "Index Memory:      " << pResult->nIndexBytes << " bytes" << endl;
+    cout << "ACMR / ATVR:       " << pResult->fACMR << " / " << pResult->fATVR 
+         << " (FIFO cache of " << pResult->nCacheSize << ")" << endl;
+    cout << "Build Time (ms):   " << pResult->fBuildTime 
+         << " (" << getSphereKernelKey( pResult->nSphereKernel ) << " kernel)" << endl;
+    cout << "Mesh Cache:        " << pResult->nNumCachedMeshes << " meshes, " 
+         << pResult->nMeshCacheBytes << " of " << pResult->nMeshCacheBudget << " bytes, "
+         << pResult->nMeshCacheHits << " hits, " << pResult->nMeshCacheMisses << " misses" << endl;
+    cout << "Startup Time (ms): " << pResult->fStartupTime << " (" << pResult->nMeshFilesLoaded 
+         << " mesh files loaded, " << pResult->nMeshFilesWritten << " written)" << endl;
+
+    for( int n = 1; n <= pResult->nNumGenerationThreads; ++n )
+    {
+        float fTime = pResult->afGenerationTime[n - 1];
+
+        cout << "Generation (ms):   " << fTime << " on " << n 
+             << (n == 1 ? " thread" : " threads") << " (" 
+             << pResult->afGenerationTime[0] / fTime << "x)" << endl;
+    }
+
+    cout << "Warm-Up Frames:    " << pResult->nWarmUpFrames << endl;
+    cout << "Elapsed Time:      " << pResult->fElapsed << endl;
+    cout << "Frames Per Second: " << pResult->fFramesPerSecond << endl;
+    cout << "Triangles/Second:  " << pResult->fTrianglesPerSecond << endl;
+    cout << "Frame Time (ms):   min " << pResult->fMinFrameTime
+         << ", p50 " << pResult->fMedianFrameTime
+         << ", p95 " << pResult->fP95FrameTime
+         << ", p99 " << pResult->fP99FrameTime
+         << ", max " << pResult->fMaxFrameTime << endl;
+    cout << "Frame Time (ms):   mean " << pResult->fMeanFrameTime
+         << ", std dev " << pResult->fStdDevFrameTime << endl;
+    cout << "Frame Split (ms):  cpu submit p50 " << pResult->fSubmitMedian
+         << ", swap p50 " << pResult->fSwapMedian;
+
+    if( pResult->nGPUFrames > 0 )
+        cout << ", gpu p50 " << pResult->fGPUMedian << " (" << pResult->nGPUFrames
+             << " timer queries, " << pResult->nLateTimerQueries << " late)" << endl;
+    else
+        cout << ", no gpu timer queries" << endl;
+
+    if( pResult->nMode == SOFTWARE_TNL )
+        cout << "Software T&L:      " << pResult->fTransformMedian << " ms p50 transforming on "
+             << pResult->nTransformThreads << " threads (" << getSphereKernelKey( pResult->nSphereKernel )
+             << "), " << pResult->fMedianFrameTime << " ms per frame against "
+             << pResult->fDriverTransformMedian << " ms with the driver's T&L" << endl;
+
+    cout << "Texture:           " << pResult->nTextureWidth << "x" << pResult->nTextureHeight 
+         << ", uploaded in " << pResult->fTextureUploadTime << " ms (";
+
+    if( pResult->bDirectTextureUpload )
+        cout << "direct";
+    else
+        cout << pResult->nTextureStrips << " strips";
+
+    cout << "), mipmaps in " << pResult->fMipmapTime << " ms" << endl;
+    if( pResult->fMipmappedMedian > 0.0f && pResult->fBaseLevelMedian > 0.0f )
+        cout << "Sampling (ms):     p50 " << pResult->fMipmappedMedian << " mipmapped, " 
+             << pResult->fBaseLevelMedian << " base level only" << endl;
+    cout << "Memory (bytes):    " << pResult->nModeBytes << " drawn from; " 
+         << pResult->nClientArrayBytes << " client arrays, " << pResult->nDisplayListBytes 
+         << " display list, " << pResult->nBufferObjectBytes << " buffer objects, " 
+         << pResult->nTextureBytes << " texture" << endl;
+
+    // Nothing was built before the first switch
+    const char *pSwitchedFrom = (pResult->nSwitchedFromMode < NUM_RENDER_MODES) ?
+                                getRenderModeKey( pResult->nSwitchedFromMode ) : "none";
+
+    cout << "Resident (bytes):  " << pResult->nResidentBytes << ", " << pResult->nRSSBeforeSwitch 
+         << " before switching from " << pSwitchedFrom << " and " << pResult->nRSSAfterSwitch 
+         << " after" << endl;
+    cout << endl;
+}
+
+//-----------------------------------------------------------------------------
+// Name: printBenchmarkJSON()
+// Desc: Same as printBenchmarkReport(), but machine readable.
+//-----------------------------------------------------------------------------
+void printBenchmarkJSON( const BenchmarkResult *pResult )
+{
+    const char *pSwitchedFrom = (pResult->nSwitchedFromMode < NUM_RENDER_MODES) ?
+                                getRenderModeKey( pResult->nSwitchedFromMode ) : "none";
+
+    printf( "{\n" );
+    printf( "  \"renderer\": \"%s\",\n", (const char *)glGetString( GL_RENDERER ) );
+    printf( "  \"mode\": \"%s\",\n", getRenderModeKey( pResult->nMode ) );
+    printf( "  \"precision\": %u,\n", pResult->nPrecision );
+    printf( "  \"layout\": \"%s\",\n", getLayoutKey( pResult->nLayout ) );
+    printf( "  \"vertex_format\": \"%s\",\n", getVertexFormatKey( pResult->nVertexFormat ) );
+    printf( "  \"bytes_per_vertex\": %u,\n", pResult->nBytesPerVertex );
+    printf( "  \"vertices\": %u,\n", pResult->nNumVertices );
+    printf( "  \"indices\": %u,\n", pResult->nNumIndices );
+    printf( "  \"vertex_bytes\": %zu,\n", pResult->nVertexBytes );
+    printf( "  \"index_bytes\": %zu,\n", pResult->nIndexBytes );
+    printf( "  \"triangles\": %u,\n", pResult->nNumTriangles );
+    printf( "  \"spheres\": %d,\n", pResult->nNumSpheres );
+    printf( "  \"scene\": \"%s\",\n", pResult->bInstanced ? "instanced" : "separate" );
+    printf( "  \"draws_per_frame\": %d,\n", pResult->nDrawsPerFrame );
+    printf( "  \"lod_target_ms\": %f,\n", pResult->fLODTargetTime );
+    printf( "  \"lod_changes\": %d,\n", pResult->nLODChanges );
+    printf( "  \"band_culling\": %s,\n", pResult->bBandCulling ? "true" : "false" );
+    printf( "  \"culled_fraction\": %f,\n", pResult->fCulledFraction );
+    printf( "  \"band_strips\": %s,\n", pResult->bBandStrips ? "true" : "false" );
+    printf( "  \"stitch_triangles_dropped\": %u,\n", pResult->nStitchTriangles );
+    printf( "  \"single_strip_p50_ms\": %f,\n", pResult->fSingleStripMedian );
+    printf( "  \"band_strips_saved_ms\": %f,\n",
+            pResult->bBandStrips ? pResult->fSingleStripMedian - pResult->fMedianFrameTime : 0.0f );
+    printf( "  \"max_edge\": %f,\n", pResult->fMaxEdge );
+    printf( "  \"max_error\": %g,\n", pResult->fMaxError );
+    printf( "  \"icosphere_frequency\": %d,\n", pResult->nIcosphereFrequency );
+    printf( "  \"equal_error_uv_precision\": %u,\n", pResult->nEqualErrorPrecision );
+    printf( "  \"equal_error_uv_vertices\": %u,\n", pResult->nEqualErrorVertices );
+    printf( "  \"equal_error_uv_p50_ms\": %f,\n", pResult->fEqualErrorMedian );
+    printf( "  \"cache_size\": %d,\n", pResult->nCacheSize );
+    printf( "  \"acmr\": %f,\n", pResult->fACMR );
+    printf( "  \"atvr\": %f,\n", pResult->fATVR );
+    printf( "  \"kernel\": \"%s\",\n", getSphereKernelKey( pResult->nSphereKernel ) );
+    printf( "  \"build_ms\": %f,\n", pResult->fBuildTime );
+    printf( "  \"mesh_cache\": {\n" );
+    printf( "    \"meshes\": %d,\n", pResult->nNumCachedMeshes );
+    printf( "    \"bytes\": %zu,\n", pResult->nMeshCacheBytes );
+    printf( "    \"budget_bytes\": %zu,\n", pResult->nMeshCacheBudget );
+    printf( "    \"hits\": %d,\n", pResult->nMeshCacheHits );
+    printf( "    \"misses\": %d\n", pResult->nMeshCacheMisses );
+    printf( "  },\n" );
+    printf( "  \"startup_ms\": %f,\n", pResult->fStartupTime );
+    printf( "  \"mesh_files\": {\n" );
+    printf( "    \"loaded\": %d,\n", pResult->nMeshFilesLoaded );
+    printf( "    \"written\": %d\n", pResult->nMeshFilesWritten );
+    printf( "  },\n" );
+    printf( "  \"generation_ms_by_threads\": [" );
+
+    for( int n = 1; n <= pResult->nNumGenerationThreads; ++n )
+        printf( n == 1 ? "%f" : ", %f", pResult->afGenerationTime[n - 1] );
+
+    printf( "],\n" );
+    printf( "  \"width\": %d,\n", g_nWindowWidth );
+    printf( "  \"height\": %d,\n", g_nWindowHeight );
+    printf( "  \"frames\": %d,\n", pResult->nFrames );
+    printf( "  \"warmup_frames\": %d,\n", pResult->nWarmUpFrames );
+    printf( "  \"elapsed_seconds\": %f,\n", pResult->fElapsed );
+    printf( "  \"frames_per_second\": %f,\n", pResult->fFramesPerSecond );
+    printf( "  \"triangles_per_second\": %f,\n", pResult->fTrianglesPerSecond );
+    printf( "  \"cpu_submit_p50_ms\": %f,\n", pResult->fSubmitMedian );
+    printf( "  \"swap_p50_ms\": %f,\n", pResult->fSwapMedian );
+    printf( "  \"gpu_p50_ms\": %f,\n", pResult->fGPUMedian );
+    printf( "  \"gpu_timed_frames\": %d,\n", pResult->nGPUFrames );
+    printf( "  \"gpu_late_queries\": %d,\n", pResult->nLateTimerQueries );
+    printf( "  \"software_transform_p50_ms\": %f,\n", pResult->fTransformMedian );
+    printf( "  \"software_transform_threads\": %d,\n", pResult->nTransformThreads );
+    printf( "  \"driver_transform_p50_ms\": %f,\n", pResult->fDriverTransformMedian );
+    printf( "  \"texture\": {\n" );
+    printf( "    \"width\": %u,\n", pResult->nTextureWidth );
+    printf( "    \"height\": %u,\n", pResult->nTextureHeight );
+    printf( "    \"upload\": \"%s\",\n", pResult->bDirectTextureUpload ? "direct" : "pbo_strips" );
+    printf( "    \"strips\": %d,\n", pResult->nTextureStrips );
+    printf( "    \"upload_ms\": %f,\n", pResult->fTextureUploadTime );
+    printf( "    \"mipmap_ms\": %f,\n", pResult->fMipmapTime );
+    printf( "    \"mipmaps\": %s\n", pResult->bMipmaps ? "true" : "false" );
+    printf( "  },\n" );
+    printf( "  \"mipmapped_p50_ms\": %f,\n", pResult->fMipmappedMedian );
+    printf( "  \"base_level_p50_ms\": %f,\n", pResult->fBaseLevelMedian );
+    printf( "  \"memory_bytes\": {\n" );
+    printf( "    \"mode\": %zu,\n", pResult->nModeBytes );
+    printf( "    \"client_arrays\": %zu,\n", pResult->nClientArrayBytes );
+    printf( "    \"display_list\": %zu,\n", pResult->nDisplayListBytes );
+    printf( "    \"buffer_objects\": %zu,\n", pResult->nBufferObjectBytes );
+    printf( "    \"texture\": %zu\n", pResult->nTextureBytes );
+    printf( "  },\n" );
+    printf( "  \"rss_bytes\": {\n" );
+    printf( "    \"switched_from\": \"%s\",\n", pSwitchedFrom );
+    printf( "    \"before_switch\": %zu,\n", pResult->nRSSBeforeSwitch );
+    printf( "    \"after_switch\": %zu,\n", pResult->nRSSAfterSwitch );
+    printf( "    \"now\": %zu\n", pResult->nResidentBytes );
+    printf( "  },\n" );
+    printf( "  \"frame_time_ms\": {\n" );
+    printf( "    \"min\": %f,\n", pResult->fMinFrameTime );
+    printf( "    \"p50\": %f,\n", pResult->fMedianFrameTime );
+    printf( "    \"p95\": %f,\n", pResult->fP95FrameTime );
+    printf( "    \"p99\": %f,\n", pResult->fP99FrameTime );
+    printf( "    \"max\": %f,\n", pResult->fMaxFrameTime );
+    printf( "    \"mean\": %f,\n", pResult->fMeanFrameTime );
+    printf( "    \"std_dev\": %f\n", pResult->fStdDevFrameTime );
+    printf( "  }\n" );
+    printf( "}\n" );
+}
+
+//-----------------------------------------------------------------------------
+// Name: render()
+// Desc: Called when the GLX window is ready to render
+//-----------------------------------------------------------------------------
+void render( void )
+{
+    uint64_t nStart = getTimeNanoseconds();
+
+    g_fTransformTime = 0.0f;
+
+    beginFrameTimer();
+
+	// Clear the screen and the depth buffer
+    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+
+    glMatrixMode( GL_MODELVIEW );
+    glLoadIdentity();
+    glTranslatef( 0.0f, 0.0f, -VIEW_DISTANCE );
+    glRotatef( -g_fSpinY, 1.0f, 0.0f, 0.0f );
+    glRotatef( -g_fSpinX, 0.0f, 1.0f, 0.0f );
+
+    if( g_bRenderInWireFrame == true )
+        glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
+    else
+        glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+
+    //
+    // Render test sphere...
+    //
+
+    glBindTexture( GL_TEXTURE_2D, g_textureID );
+
+    drawSphereScene();
+
+    endFrameTimer();
+
+    uint64_t nSubmitted = getTimeNanoseconds();
+
+    if( g_bHeadless )
+        glFlush(); // Nothing to present, the p-buffer is single buffered
+    else if( g_bDoubleBuffered )
+        glXSwapBuffers( g_pDisplay, g_window ); // Buffer swap does implicit glFlush
+    else
+        glFlush(); // Explicit flush for single buffered case
+
+    g_fSubmitTime = (nSubmitted - nStart) / 1000000.0f;
+    g_fSwapTime   = (getTimeNanoseconds() - nSubmitted) / 1000000.0f;
+}
+
+//-----------------------------------------------------------------------------
+// Name: drawSphere()
+// Desc: Draws the current sphere once, with the current render mode.
+//-----------------------------------------------------------------------------
+void drawSphere( void )
+{
+    if( g_nCurrentMode == IMMEDIATE_MODE )
+    {
+        // Render a textured sphere using immediate mode
+
+        // To be fair to immediate mode, we won't force it incur the overhead 
+        // of calling hundreds of math subroutines to generate a sphere each 
+        // frame, instead, we'll use the same array that we would use for 
+        // testing the vertex array, but we'll make the immediate mode calls 
+        // ourselves. This is more typical of how a real app would use 
+        // immediate mode calls.
+
+        bool   bIndexed     = (g_nSphereLayout != STRIP_LAYOUT);
+        GLuint nNumElements = bIndexed ? g_nNumSphereIndices : g_nNumSphereVertices;
+
+        glBegin( bIndexed ? g_sphereIndexPrimitive : GL_TRIANGLE_STRIP );
+        {
+            for( GLuint k = 0; k < nNumElements; ++k )
+            {
+                GLuint i = bIndexed ? getIndexData( k ) : k;
+
+                glNormal3f( (g_pSphereVertices+i)->nx,
+                            (g_pSphereVertices+i)->ny,
+                            (g_pSphereVertices+i)->nz );
+
+                glTexCoord2f( (g_pSphereVertices+i)->tu,
+                              (g_pSphereVertices+i)->tv );
+
+                glVertex3f( (g_pSphereVertices+i)->vx,
+                            (g_pSphereVertices+i)->vy,
+                            (g_pSphereVertices+i)->vz );
+            }
+        }
+        glEnd();
+    }
+
+    if( g_nCurrentMode == DISPLAY_LIST )
+    {
+        // Render a textured sphere as a display list
+        glCallList( g_sphereDList );
+    }
+
+    if( g_nCurrentMode == VERTEX_ARRAY )
+    {
+        // Render a textured sphere using a vertex array
+        beginSphereArrays( (const GLubyte *)getSphereVertexData() );
+
+        if( g_nSphereLayout != STRIP_LAYOUT )
+            glDrawElements( g_sphereIndexPrimitive, g_nNumSphereIndices, g_sphereIndexType, g_pSphereIndices );
+        else if( canCullBands() )
+            drawVisibleBands();
+        else if( canDrawBandStrips() )
+            drawBandStrips();
+        else
+            glDrawArrays( GL_TRIANGLE_STRIP, 0, g_nNumSphereVertices );
+
+        endSphereArrays();
+    }
+
+    if( g_nCurrentMode == VERTEX_BUFFER )
+    {
+        // Render a textured sphere from the buffer object, where the array 
+        // pointer is an offset into the bound buffer rather than an address
+        glBindBuffer( GL_ARRAY_BUFFER, g_sphereVBO );
+        beginSphereArrays( (const GLubyte *)0 );
+
+        if( g_nSphereLayout != STRIP_LAYOUT )
+        {
+            glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, g_sphereIBO );
+            glDrawElements( g_sphereIndexPrimitive, g_nNumSphereIndices, g_sphereIndexType, (const GLvoid *)0 );
+            glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+        }
+        else if( canCullBands() )
+            drawVisibleBands();
+        else if( canDrawBandStrips() )
+            drawBandStrips();
+        else
+            glDrawArrays( GL_TRIANGLE_STRIP, 0, g_nNumSphereVertices );
+
+        endSphereArrays();
+        glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    }
+
+    if( g_nCurrentMode == STREAMING_MODE )
+    {
+        // Render a textured sphere that's regenerated as it's drawn
+        renderSphereStream();
+    }
+
+    if( g_nCurrentMode == PROCEDURAL )
+    {
+        // Render a textured sphere made up by the vertex shader
+        renderSphereProcedural();
+    }
+
+    if( g_nCurrentMode == IMPOSTOR_MODE )
+    {
+        // Render a textured sphere ray-cast by the fragment shader
+        renderSphereImpostor();
+    }
+
+    if( g_nCurrentMode == SOFTWARE_TNL )
+    {
+        // Render a textured sphere transformed on the CPU
+        renderSphereSoftware();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: drawSphereScene()
+// Desc: Draws every sphere of the scene, either with one instanced call or 
+//       with one drawSphere() each. The classic single sphere is drawn 
+//       without touching the matrices at all.
+//-----------------------------------------------------------------------------
+void drawSphereScene( void )
+{
+    if( g_bInstancedScene && canDrawInstanced() )
+    {
+        drawSphereInstances();
+        return;
+    }
+
+    if( g_nNumSpheres == 1 )
+    {
+        drawSphere();
+        return;
+    }
+
+    for( int i = 0; i < g_nNumSpheres; ++i )
+    {
+        const SphereInstance *pInstance = &g_pSphereInstances[i];
+
+        // The texture stack may only be two deep, and the short vertex 
+        // format already pushes it, so the offset is loaded rather than 
+        // pushed.
+        glMatrixMode( GL_TEXTURE );
+        glLoadIdentity();
+        glTranslatef( pInstance->tu, 0.0f, 0.0f );
+
+        glMatrixMode( GL_MODELVIEW );
+        glPushMatrix();
+        glTranslatef( pInstance->x, pInstance->y, pInstance->z );
+        glScalef( pInstance->scale, pInstance->scale, pInstance->scale );
+
+        drawSphere();
+
+        glPopMatrix();
+    }
+
+    glMatrixMode( GL_TEXTURE );
+    glLoadIdentity();
+    glMatrixMode( GL_MODELVIEW );
+}
+
+//-----------------------------------------------------------------------------
+// Name: canDrawInstanced()
+// Desc: Only the array modes keep the whole sphere somewhere an instanced 
+//       draw can read it from.
+//-----------------------------------------------------------------------------
+bool canDrawInstanced( void )
+{
+    return (g_nCurrentMode == VERTEX_ARRAY || g_nCurrentMode == VERTEX_BUFFER) && 
+           g_instanceProgram != 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: drawSphereInstances()
+// Desc: Draws every sphere of the scene with a single instanced call. The 
+//       fixed-function pipeline has no per-instance attributes, so a small 
+//       shader applies each sphere's transform and texture offset, which 
+//       it reads from g_instanceVBO with a divisor of 1. Integer positions 
+//       and texture coordinates are normalized by the attribute setup 
+//       rather than by the matrices.
+//-----------------------------------------------------------------------------
+void drawSphereInstances( void )
+{
+    const GLubyte *pBase   = (const GLubyte *)getSphereVertexData();
+    float          fScale  = 1.0f;
+    GLsizei        nStride = getVertexFormatSize( g_nVertexFormat );
+
+    if( g_nCurrentMode == VERTEX_BUFFER )
+    {
+        glBindBuffer( GL_ARRAY_BUFFER, g_sphereVBO );
+        pBase = (const GLubyte *)0;
+    }
+
+    glUseProgram( g_instanceProgram );
+
+    if( g_nVertexFormat == FLOAT_FORMAT )
+    {
+        glVertexAttribPointer( POSITION_ATTRIB, 3, GL_FLOAT, GL_FALSE, nStride, pBase + offsetof(Vertex, vx) );
+        glVertexAttribPointer( TEXCOORD_ATTRIB, 2, GL_FLOAT, GL_FALSE, nStride, pBase + offsetof(Vertex, tu) );
+    }
+
+    if( g_nVertexFormat == HALF_FORMAT )
+    {
+        glVertexAttribPointer( POSITION_ATTRIB, 3, GL_FLOAT, GL_FALSE, nStride, pBase + offsetof(HalfVertex, vx) );
+        glVertexAttribPointer( TEXCOORD_ATTRIB, 2, GL_HALF_FLOAT, GL_FALSE, nStride, pBase + offsetof(HalfVertex, tu) );
+    }
+
+    if( g_nVertexFormat == SHORT_FORMAT )
+    {
+        glVertexAttribPointer( POSITION_ATTRIB, 3, GL_SHORT, GL_TRUE, nStride, pBase + offsetof(ShortVertex, vx) );
+        glVertexAttribPointer( TEXCOORD_ATTRIB, 2, GL_SHORT, GL_TRUE, nStride, pBase + offsetof(ShortVertex, tu) );
+        fScale = g_fPackedPositionScale * 32767.0f;
+    }
+
+    glUniform1f( g_nPositionScaleLoc, fScale );
+
+    glBindBuffer( GL_ARRAY_BUFFER, g_instanceVBO );
+    glVertexAttribPointer( INSTANCE_ATTRIB, 4, GL_FLOAT, GL_FALSE, sizeof(SphereInstance), 
+                           (const GLvoid *)offsetof(SphereInstance, x) );
+    glVertexAttribPointer( INSTANCE_OFFSET_ATTRIB, 1, GL_FLOAT, GL_FALSE, sizeof(SphereInstance), 
+                           (const GLvoid *)offsetof(SphereInstance, tu) );
+    glVertexAttribDivisor( INSTANCE_ATTRIB, 1 );
+    glVertexAttribDivisor( INSTANCE_OFFSET_ATTRIB, 1 );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    for( GLuint nAttrib = POSITION_ATTRIB; nAttrib <= INSTANCE_OFFSET_ATTRIB; ++nAttrib )
+        glEnableVertexAttribArray( nAttrib );
+
+    if( g_nSphereLayout != STRIP_LAYOUT )
+    {
+        const GLvoid *pIndices = g_pSphereIndices;
+
+        if( g_nCurrentMode == VERTEX_BUFFER )
+        {
+            glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, g_sphereIBO );
+            pIndices = (const GLvoid *)0;
+        }
+
+        glDrawElementsInstanced( g_sphereIndexPrimitive, g_nNumSphereIndices, g_sphereIndexType, 
+                                 pIndices, g_nNumSpheres );
+        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+    }
+    else
+        glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, g_nNumSphereVertices, g_nNumSpheres );
+
+    for( GLuint nAttrib = POSITION_ATTRIB; nAttrib <= INSTANCE_OFFSET_ATTRIB; ++nAttrib )
+        glDisableVertexAttribArray( nAttrib );
+
+    glVertexAttribDivisor( INSTANCE_ATTRIB, 0 );
+    glVertexAttribDivisor( INSTANCE_OFFSET_ATTRIB, 0 );
+    glUseProgram( 0 );
+}
+
+//-----------------------------------------------------------------------------
+// Name: createSphereInstances()
+// Desc: Lays the spheres of the scene out on the smallest cubic grid that 
+//       holds them, inside the space the single sphere takes up, and builds
+//       the buffer and shader the instanced draw reads them with. A single 
+//       sphere is left exactly as the classic benchmark draws it.
+//-----------------------------------------------------------------------------
+void createSphereInstances( void )
+{
+    g_pSphereInstances = new SphereInstance[g_nNumSpheres];
+
+    int   nCells = (int)ceilf( cbrtf( (float)g_nNumSpheres ) - 0.0001f );
+    float fCell  = 2.0f * g_fSphereRadius / nCells;
+
+    for( int i = 0; i < g_nNumSpheres; ++i )
+    {
+        SphereInstance *pInstance = &g_pSphereInstances[i];
+
+        if( g_nNumSpheres == 1 )
+        {
+            pInstance->x     = 0.0f;
+            pInstance->y     = 0.0f;
+            pInstance->z     = 0.0f;
+            pInstance->scale = 1.0f;
+            pInstance->tu    = 0.0f;
+            continue;
+        }
+
+        pInstance->x     = ((i % nCells) + 0.5f) * fCell - g_fSphereRadius;
+        pInstance->y     = ((i / nCells % nCells) + 0.5f) * fCell - g_fSphereRadius;
+        pInstance->z     = ((i / (nCells * nCells)) + 0.5f) * fCell - g_fSphereRadius;
+        pInstance->scale = 0.45f * fCell / g_fSphereRadius;
+
+        // The golden ratio spreads the offsets evenly around the texture
+        pInstance->tu    = fmodf( i * 0.618034f, 1.0f );
+    }
+
+    glGenBuffers( 1, &g_instanceVBO );
+    glBindBuffer( GL_ARRAY_BUFFER, g_instanceVBO );
+    glBufferData( GL_ARRAY_BUFFER, g_nNumSpheres * sizeof(SphereInstance), 
+                  g_pSphereInstances, GL_STATIC_DRAW );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    if( !g_bInstancedScene )
+        return;
+
+    const char *pVertexSource =
+        "#version 120\n"
+        "uniform float positionScale;\n"
+        "attribute vec3 position;\n"
+        "attribute vec2 texCoord;\n"
+        "attribute vec4 instance;\n"
+        "attribute float instanceOffset;\n"
+        "varying vec2 sphereTexCoord;\n"
+        "void main()\n"
+        "{\n"
+        "    vec3 p = instance.xyz + instance.w * positionScale * position;\n"
+        "    sphereTexCoord = vec2( texCoord.x + instanceOffset, texCoord.y );\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * vec4( p, 1.0 );\n"
+        "}\n";
+
+    // Same as the fixed-function GL_MODULATE with a white color
+    const char *pFragmentSource =
+        "#version 120\n"
+        "uniform sampler2D marsTexture;\n"
+        "varying vec2 sphereTexCoord;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_FragColor = texture2D( marsTexture, sphereTexCoord );\n"
+        "}\n";
+
+    // In the order of the *_ATTRIB slots
+    const char *apAttribNames[] = { "position", "texCoord", "instance", "instanceOffset" };
+
+    g_instanceProgram = createShaderProgram( pVertexSource, pFragmentSource, apAttribNames, 4 );
+
+    if( g_instanceProgram == 0 )
+    {
+        cerr << "ERROR: createSphereInstances - Falling back to a draw per sphere." << endl;
+        return;
+    }
+
+    g_nPositionScaleLoc = glGetUniformLocation( g_instanceProgram, "positionScale" );
+}
+
+//-----------------------------------------------------------------------------
+// Name: createShaderProgram()
+// Desc: Compiles and links a vertex and a fragment shader, with attribute 
+//       ppAttribNames[i] bound to slot i. Returns 0, after printing the info
+//       log, if either fails.
+//-----------------------------------------------------------------------------
+GLuint createShaderProgram( const char *pVertexSource, const char *pFragmentSource,
+                            const char **ppAttribNames, int nNumAttribs )
+{
+    GLuint vertexShader   = compileShader( GL_VERTEX_SHADER, pVertexSource );
+    GLuint fragmentShader = compileShader( GL_FRAGMENT_SHADER, pFragmentSource );
+
+    if( vertexShader == 0 || fragmentShader == 0 )
+    {
+        glDeleteShader( vertexShader );
+        glDeleteShader( fragmentShader );
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader( program, vertexShader );
+    glAttachShader( program, fragmentShader );
+
+    for( int i = 0; i < nNumAttribs; ++i )
+        glBindAttribLocation( program, i, ppAttribNames[i] );
+
+    glLinkProgram( program );
+
+    // The program keeps them alive for as long as it needs them
+    glDeleteShader( vertexShader );
+    glDeleteShader( fragmentShader );
+
+    GLint nLinked = GL_FALSE;
+    glGetProgramiv( program, GL_LINK_STATUS, &nLinked );
+
+    if( nLinked != GL_TRUE )
+    {
+        char log[1024];
+        glGetProgramInfoLog( program, sizeof(log), NULL, log );
+        cerr << "ERROR: createShaderProgram - Couldn't link the program: " << log << endl;
+
+        glDeleteProgram( program );
+        return 0;
+    }
+
+    return program;
+}
+
+//-----------------------------------------------------------------------------
+// Name: compileShader()
+// Desc: 
 //-----------------------------------------------------------------------------
-// Name: setVertData()
-// Desc: Helper function for createSphereGeometry()
+GLuint compileShader( GLenum type, const char *pSource )
+{
+    GLuint shader = glCreateShader( type );
+    glShaderSource( shader, 1, &pSource, NULL );
+    glCompileShader( shader );
+
+    GLint nCompiled = GL_FALSE;
+    glGetShaderiv( shader, GL_COMPILE_STATUS, &nCompiled );
+
+    if( nCompiled != GL_TRUE )
+    {
+        char log[1024];
+        glGetShaderInfoLog( shader, sizeof(log), NULL, log );
+        cerr << "ERROR: compileShader - Couldn't compile the shader: " << log << endl;
+
+        glDeleteShader( shader );
+        return 0;
+    }
+
+    return shader;
+}
+
+//-----------------------------------------------------------------------------
+// Name: updateLODController()
+// Desc: Called once a frame with how long the last one took. Every 
+//       LOD_WINDOW_FRAMES frames, if their median is over the budget by more
+//       than LOD_LOWER_ABOVE or under it by more than LOD_RAISE_BELOW, the 
+//       precision is scaled to bring it back. The triangle count grows with
+//       the square of the precision, so the step is the square root of how 
+//       far off the frame time is, and it's limited to keep one odd frame 
+//       from swinging it too far. Frames drawn while the builder thread is 
+//       still on the next sphere don't say anything about it, so they're 
+//       left out.
 //-----------------------------------------------------------------------------
-void setVertData( int index,
-                 float tu, float tv, 
-                 float nx, float ny, float nz, 
-                 float vx, float vy, float vz )	
+void updateLODController( float fFrameTime )
 {
-    (g_pSphereVertices+index)->tu = tu;
-    (g_pSphereVertices+index)->tv = tv;
-    (g_pSphereVertices+index)->nx = nx;
-    (g_pSphereVertices+index)->ny = ny;
-    (g_pSphereVertices+index)->nz = nz;
-    (g_pSphereVertices+index)->vx = vx;
-    (g_pSphereVertices+index)->vy = vy;
-    (g_pSphereVertices+index)->vz = vz;
+    if( !g_bAdaptiveLOD )
+        return;
+
+    if( g_bBuilderRunning )
+    {
+        g_nLODFrames = 0;
+        return;
+    }
+
+    g_afLODFrameTimes[g_nLODFrames++] = fFrameTime;
+
+    if( g_nLODFrames < LOD_WINDOW_FRAMES )
+        return;
+
+    g_nLODFrames = 0;
+
+    float afSorted[LOD_WINDOW_FRAMES];
+    memcpy( afSorted, g_afLODFrameTimes, sizeof(afSorted) );
+    sort( afSorted, afSorted + LOD_WINDOW_FRAMES );
+
+    float  fMedian    = getPercentile( afSorted, LOD_WINDOW_FRAMES, 50.0f );
+    GLuint nCap       = getLODPrecisionCap();
+    GLuint nPrecision = g_nPrecision;
+
+    if( fMedian > g_fLODTargetTime * LOD_LOWER_ABOVE || 
+        fMedian < g_fLODTargetTime * LOD_RAISE_BELOW )
+    {
+        float fStep = sqrtf( g_fLODTargetTime / max( fMedian, 0.001f ) );
+
+        fStep      = min( max( fStep, 0.7f ), 1.4f );
+        nPrecision = (GLuint)(g_nPrecision * fStep) & ~1u;
+    }
+
+    // Also pulls the precision back when the sphere got smaller on screen
+    nPrecision = min( max( nPrecision, (GLuint)MIN_LOD_PRECISION ), nCap );
+
+    if( nPrecision == g_nPrecision )
+        return;
+
+    g_nPrecision = nPrecision;
+    ++g_nLODChanges;
+
+    if( !g_bHeadless )
+        cout << "Adaptive LOD: Sphere Resolution = " << g_nPrecision 
+             << " (median frame " << fMedian << " ms)" << endl;
+
+    rebuildSphereInBackground();
 }
 
 //-----------------------------------------------------------------------------
-// Name: createSphereGeometry()
-// Desc: Creates a sphere as an array of vertex data suitable to be fed into a 
-//       OpenGL vertex array. The sphere will be centered at cy, cx, cz with 
-//       radius r, and precision p. Based on a function Written by Paul Bourke. 
-//       http://astronomy.swin.edu.au/~pbourke/opengl/sphere/
+// Name: getSphereScreenRadius()
+// Desc: Radius in pixels of one sphere's silhouette, as seen from 
+//       VIEW_DISTANCE through the projection init() sets up. Every sphere of
+//       the scene is taken to be as far as the middle of the grid.
 //-----------------------------------------------------------------------------
-void createSphereGeometry( float cx, float cy, float cz, float r, int p )	
+float getSphereScreenRadius( void )
+{
+    const float DEGTORAD = 0.0174532925199433f;
+
+    float r = g_fSphereRadius * g_pSphereInstances[0].scale;
+    float d = VIEW_DISTANCE;
+
+    if( r >= d )
+        return (float)g_nWindowHeight;
+
+    return 0.5f * g_nWindowHeight * (r / sqrtf( d*d - r*r )) / tanf( 0.5f * FIELD_OF_VIEW * DEGTORAD );
+}
+
+//-----------------------------------------------------------------------------
+// Name: getLODPrecisionCap()
+// Desc: The finest precision worth drawing at the sphere's current size. 
+//       The precision is the number of edges around the equator.
+//-----------------------------------------------------------------------------
+GLuint getLODPrecisionCap( void )
 {
     const float TWOPI = 6.28318530717958f;
-    const float PIDIV2 = 1.57079632679489f;
 
-    float theta1 = 0.0;
-    float theta2 = 0.0;
-    float theta3 = 0.0;
+    float fCap = TWOPI * getSphereScreenRadius() / LOD_PIXELS_PER_EDGE;
 
-    float ex = 0.0f;
-    float ey = 0.0f;
-    float ez = 0.0f;
+    fCap = min( max( fCap, (float)MIN_LOD_PRECISION ), (float)MAX_LOD_PRECISION );
 
-    float px = 0.0f;
-    float py = 0.0f;
-    float pz = 0.0f;
+    return (GLuint)fCap & ~1u;
+}
 
-    float tu  = 0.0f;
-    float tv  = 0.0f;
+//-----------------------------------------------------------------------------
+// Name: canCullBands()
+// Desc: Culling draws runs of the strip layout's bands with 
+//       glMultiDrawArrays(), so it needs the whole strip in an array. With 
+//       more than one sphere each would need a view of its own, so the 
+//       scene is drawn whole. An odd precision leaves a hole at the top 
+//       pole that the inside of the sphere can be seen through, so only 
+//       closed spheres are culled. That's the sphere that's bound, which 
+//       can lag g_nPrecision while it's being rebuilt.
+//-----------------------------------------------------------------------------
+bool canCullBands( void )
+{
+    return g_bBandCulling && g_nNumSpheres == 1 && g_nSphereLayout == STRIP_LAYOUT &&
+           g_nMeshPrecision % 2 == 0 &&
+           (g_nCurrentMode == VERTEX_ARRAY || g_nCurrentMode == VERTEX_BUFFER);
+}
 
-    //-------------------------------------------------------------------------
-    // If sphere precision is set to 4, then 20 verts will be needed to 
-    // hold the array of GL_TRIANGLE_STRIP(s) and so on...
-    //
-    // Example:
-    //
-    // total_verts = (p/2) * ((p+1)*2)
-    // total_verts = (4/2) * (  5  *2)
-    // total_verts =   2   *  10
-    // total_verts =      20
-    //-------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// Name: createCullCones()
+// Desc: Splits each band of the current sphere into CULL_SEGMENTS runs of 
+//       columns, and bounds the normals of each run with a cone around the
+//       normal at its middle. A lat/long patch's normals stray the furthest
+//       from the middle at its corners or edges, so those are all tried.
+//-----------------------------------------------------------------------------
+void createCullCones( void )
+{
+    const float TWOPI  = 6.28318530717958f;
+    const float PIDIV2 = 1.57079632679489f;
 
-    g_nNumSphereVertices = (p/2) * ((p+1)*2);
+    destroyCullCones();
 
-    if( g_pSphereVertices != NULL )
+    int p         = g_nMeshPrecision;
+    int nNumBands = p/2;
+    int nCols     = (p + CULL_SEGMENTS - 1) / CULL_SEGMENTS;
+
+    g_nCullPrecision   = p;
+    g_nCullSegmentCols = nCols;
+    g_pCullCones       = new CullCone[nNumBands * CULL_SEGMENTS];
+    g_pCullFirsts      = new GLint[nNumBands * CULL_SEGMENTS];
+    g_pCullCounts      = new GLsizei[nNumBands * CULL_SEGMENTS];
+
+    for( int i = 0; i < nNumBands; ++i )
     {
-        delete []g_pSphereVertices;
-        g_pSphereVertices = NULL;
-        g_pSphereVertices = new Vertex[g_nNumSphereVertices];
+        for( int s = 0; s < CULL_SEGMENTS; ++s )
+        {
+            CullCone *pCone = &g_pCullCones[i * CULL_SEGMENTS + s];
+            int       j0    = min( s * nCols, p );
+            int       j1    = min( (s + 1) * nCols, p );
+
+            // Ring i+1 and ring i, columns j0 to j1, as in createSphereTables()
+            float afLat[3] = { i * TWOPI / p - PIDIV2, (i + 0.5f) * TWOPI / p - PIDIV2, (i + 1) * TWOPI / p - PIDIV2 };
+            float afLon[3] = { j0 * TWOPI / p, (j0 + j1) * 0.5f * TWOPI / p, j1 * TWOPI / p };
+
+            pCone->ax = cosf( afLat[1] ) * cosf( afLon[1] );
+            pCone->ay = sinf( afLat[1] );
+            pCone->az = cosf( afLat[1] ) * sinf( afLon[1] );
+
+            float fMinCos = 1.0f;
+
+            for( int a = 0; a < 3; ++a )
+            {
+                for( int b = 0; b < 3; ++b )
+                {
+                    float fCos = cosf( afLat[a] ) * cosf( afLon[b] ) * pCone->ax + 
+                                 sinf( afLat[a] ) * pCone->ay + 
+                                 cosf( afLat[a] ) * sinf( afLon[b] ) * pCone->az;
+
+                    fMinCos = min( fMinCos, fCos );
+                }
+            }
+
+            // A little slack for the rounding of the vertices themselves
+            float fAngle = acosf( max( min( fMinCos, 1.0f ), -1.0f ) ) + 0.001f;
+
+            pCone->fCos = cosf( fAngle );
+            pCone->fSin = sinf( fAngle );
+        }
     }
-    else
+}
+
+//-----------------------------------------------------------------------------
+// Name: destroyCullCones()
+// Desc: 
+//-----------------------------------------------------------------------------
+void destroyCullCones( void )
+{
+    delete []g_pCullCones;
+    delete []g_pCullFirsts;
+    delete []g_pCullCounts;
+
+    g_pCullCones     = NULL;
+    g_pCullFirsts    = NULL;
+    g_pCullCounts    = NULL;
+    g_nCullPrecision = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getSphereEye()
+// Desc: The eye in the sphere's own space, undoing the rotations render() 
+//       applies after moving the sphere VIEW_DISTANCE away.
+//-----------------------------------------------------------------------------
+void getSphereEye( float *pEye )
+{
+    const float DEGTORAD = 0.0174532925199433f;
+
+    float a = g_fSpinY * DEGTORAD;
+    float b = g_fSpinX * DEGTORAD;
+
+    pEye[0] =  VIEW_DISTANCE * cosf( a ) * sinf( b );
+    pEye[1] = -VIEW_DISTANCE * sinf( a );
+    pEye[2] =  VIEW_DISTANCE * cosf( a ) * cosf( b );
+}
+
+//-----------------------------------------------------------------------------
+// Name: drawVisibleBands()
+// Desc: Draws the runs of each band whose cone has a normal facing the eye,
+//       with a single glMultiDrawArrays(). A plane with normal n at h from 
+//       the center faces an eye at distance d along u when n.u > h/d. The 
+//       triangles of a run are chords whose planes are at least 
+//       r * cos(alpha) from the center, alpha being the cone's half-angle, 
+//       so a run is culled once the angle between the cone's axis and u is 
+//       at least alpha plus acos(r * cos(alpha) / d). Neighbouring visible 
+//       runs of a band are joined into one strip, and the bands are drawn 
+//       apart, so no triangle stitches them together.
+//-----------------------------------------------------------------------------
+void drawVisibleBands( void )
+{
+    if( g_pCullCones == NULL || g_nCullPrecision != g_nMeshPrecision )
     {
-        g_pSphereVertices = new Vertex[g_nNumSphereVertices];
+        glDrawArrays( GL_TRIANGLE_STRIP, 0, g_nNumSphereVertices );
+        return;
     }
 
-    // Disallow a negative number for radius.
-    if( r < 0 )
-        r = -r;
+    float e[3];
+    getSphereEye( e );
 
-    // Disallow a negative number for precision.
-    if( p < 4 ) 
-        p = 4;
+    float d    = sqrtf( e[0]*e[0] + e[1]*e[1] + e[2]*e[2] );
+    float u[3] = { e[0] / d, e[1] / d, e[2] / d };
 
-    int k = -1;
+    int    p          = g_nCullPrecision;
+    int    nBandVerts = (p+1)*2;
+    int    nNumRuns   = 0;
+    GLuint nSubmitted = 0;
 
     for( int i = 0; i < p/2; ++i )
     {
-        theta1 = i * TWOPI / p - PIDIV2;
-        theta2 = (i + 1) * TWOPI / p - PIDIV2;
+        int nRunStart = -1;
 
-        for( int j = 0; j <= p; ++j )
+        for( int s = 0; s <= CULL_SEGMENTS; ++s )
         {
-            theta3 = j * TWOPI / p;
+            bool bVisible = false;
 
-            ex = cosf(theta2) * cosf(theta3);
-            ey = sinf(theta2);
-            ez = cosf(theta2) * sinf(theta3);
-            px = cx + r * ex;
-            py = cy + r * ey;
-            pz = cz + r * ez;
-            tu  = -(j/(float)p);
-            tv  = 2*(i+1)/(float)p;
+            if( s < CULL_SEGMENTS && s * g_nCullSegmentCols < p )
+            {
+                const CullCone *pCone = &g_pCullCones[i * CULL_SEGMENTS + s];
+
+                float fDot  = pCone->ax * u[0] + pCone->ay * u[1] + pCone->az * u[2];
+                float fCosB = pCone->fCos * g_fSphereRadius / d;
+                float fSinB = sqrtf( max( 1.0f - fCosB * fCosB, 0.0f ) );
+
+                // cos(alpha + beta), where beta = acos(r * cos(alpha) / d). 
+                // Once alpha + beta reaches pi every direction is inside.
+                float fCosLimit = pCone->fCos * fCosB - pCone->fSin * fSinB;
+
+                bVisible = (pCone->fCos <= -fCosB) || fDot > fCosLimit;
+            }
+
+            if( bVisible && nRunStart < 0 )
+                nRunStart = s;
 
-            ++k;
-            setVertData( k, tu, tv, ex, ey, ez, px, py, pz );
+            if( !bVisible && nRunStart >= 0 )
+            {
+                int j0 = nRunStart * g_nCullSegmentCols;
+                int j1 = min( s * g_nCullSegmentCols, p );
 
-            ex = cosf(theta1) * cosf(theta3);
-            ey = sinf(theta1);
-            ez = cosf(theta1) * sinf(theta3);
-            px = cx + r * ex;
-            py = cy + r * ey;
-            pz = cz + r * ez;
-            tu  = -(j/(float)p);
-            tv  = 2*i/(float)p;
+                g_pCullFirsts[nNumRuns] = i * nBandVerts + j0 * 2;
+                g_pCullCounts[nNumRuns] = (j1 - j0 + 1) * 2;
+                nSubmitted             += g_pCullCounts[nNumRuns];
+                ++nNumRuns;
 
-            ++k;
-            setVertData( k, tu, tv, ex, ey, ez, px, py, pz );
+                nRunStart = -1;
+            }
         }
     }
+
+    g_nSubmittedVertices += nSubmitted;
+    g_nCulledVertices    += g_nNumSphereVertices - min( g_nNumSphereVertices, nSubmitted );
+
+    if( nNumRuns > 0 )
+        glMultiDrawArrays( GL_TRIANGLE_STRIP, g_pCullFirsts, g_pCullCounts, nNumRuns );
 }
 
 //-----------------------------------------------------------------------------
-// Name: doBenchmark()
-// Desc: 
+// Name: canDrawBandStrips()
+// Desc: Per-band strips need the strip layout in an array, and culling
+//       already draws the bands apart. An instanced draw has no multi-draw
+//       to go with it, so it keeps the single strip.
 //-----------------------------------------------------------------------------
-void doBenchmark()
+bool canDrawBandStrips( void )
+{
+    return g_bBandStrips && g_nSphereLayout == STRIP_LAYOUT && !canCullBands() &&
+           !(g_bInstancedScene && canDrawInstanced()) &&
+           (g_nCurrentMode == VERTEX_ARRAY || g_nCurrentMode == VERTEX_BUFFER);
+}
+
+//-----------------------------------------------------------------------------
+// Name: drawBandStrips()
+// Desc: Draws the bands of the current sphere's strip layout as strips of
+//       their own. Until the bands have been worked out for the mesh that's
+//       bound, which lags behind while it's being rebuilt, it's drawn as the
+//       single strip instead.
+//-----------------------------------------------------------------------------
+void drawBandStrips( void )
+{
+    if( g_pBandFirsts == NULL || g_nBandStripPrecision != g_nMeshPrecision )
+    {
+        glDrawArrays( GL_TRIANGLE_STRIP, 0, g_nNumSphereVertices );
+        return;
+    }
+
+    glMultiDrawArrays( GL_TRIANGLE_STRIP, g_pBandFirsts, g_pBandCounts, g_nBandStripPrecision/2 );
+}
+
+//-----------------------------------------------------------------------------
+// Name: createBandStrips()
+// Desc: The first vertex and the vertex count of every band of the current
+//       sphere's strip layout.
+//-----------------------------------------------------------------------------
+void createBandStrips( void )
+{
+    destroyBandStrips();
+
+    int p          = g_nMeshPrecision;
+    int nBandVerts = (p+1)*2;
+
+    g_nBandStripPrecision = p;
+    g_pBandFirsts         = new GLint[p/2];
+    g_pBandCounts         = new GLsizei[p/2];
+
+    for( int i = 0; i < p/2; ++i )
+    {
+        g_pBandFirsts[i] = i * nBandVerts;
+        g_pBandCounts[i] = nBandVerts;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: destroyBandStrips()
+// Desc:
+//-----------------------------------------------------------------------------
+void destroyBandStrips( void )
 {
-    timeb start;
-    timeb finish;
-    float  fElapsed = 0.0f;
-    int    nFrames  = 1000;
+    delete []g_pBandFirsts;
+    delete []g_pBandCounts;
 
-    ftime( &start );  // Get the time
+    g_pBandFirsts         = NULL;
+    g_pBandCounts         = NULL;
+    g_nBandStripPrecision = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: timeMedianFrame()
+// Desc: Median time of nFrames frames, for a quick comparison against the
+//       frames runBenchmark() just timed.
+//-----------------------------------------------------------------------------
+float timeMedianFrame( int nFrames )
+{
+    float *pFrameTimes = new float[nFrames];
+
+    render();
+    glFinish();
+
+    for( int i = 0; i < nFrames; ++i )
+    {
+        uint64_t nStart = getTimeNanoseconds();
 
-    while( nFrames-- ) // Loop away
         render();
+        glFinish();
 
-    ftime( &finish ); // Get the time again
+        pFrameTimes[i] = (getTimeNanoseconds() - nStart) / 1000000.0f;
+    }
 
-    fElapsed  = (float)(finish.time - start.time);                // This is accurate to one second
-    fElapsed += (float)((finish.millitm - start.millitm)/1000.0); // This gets it down to one ms
+    sort( pFrameTimes, pFrameTimes + nFrames );
 
-    cout << endl;
-    cout << "-- Benchmark Report --" << endl;
+    float fMedian = getPercentile( pFrameTimes, nFrames, 50.0f );
 
-    if( g_nCurrentMode == IMMEDIATE_MODE )
-        cout << "Render Method:     Immediate Mode" << endl;
-    if( g_nCurrentMode == DISPLAY_LIST )
-        cout << "Render Method:     Display List" << endl;
-    if( g_nCurrentMode == VERTEX_ARRAY )
-        cout << "Render Method:     Vertex Array" << endl;
+    delete []pFrameTimes;
 
-    cout << "Frames Rendered:   1000" << endl;
-    cout << "Sphere Resolution: " << g_nPrecision << endl;
-    cout << "Primitive Used:    GL_TRIANGLE_STRIP" << endl;
-    cout << "Elapsed Time:      " << fElapsed << endl;
-    cout << "Frames Per Second: " << 1000.0/fElapsed << endl;
-    cout << endl;
+    return fMedian;
 }
 
 //-----------------------------------------------------------------------------
-// Name: render()
-// Desc: Called when the GLX window is ready to render
+// Name: createFrameTimers()
+// Desc: Timer queries are core since OpenGL 3.3, and need ARB_timer_query
+//       before that. Without them only the CPU side of a frame is timed.
 //-----------------------------------------------------------------------------
-void render( void )
+void createFrameTimers( void )
 {
-	// Clear the screen and the depth buffer
-    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+    const char *pVersion    = (const char *)glGetString( GL_VERSION );
+    const char *pExtensions = (const char *)glGetString( GL_EXTENSIONS );
 
-    glMatrixMode( GL_MODELVIEW );
-    glLoadIdentity();
-    glTranslatef( 0.0f, 0.0f, -5.0f );
-    glRotatef( -g_fSpinY, 1.0f, 0.0f, 0.0f );
-    glRotatef( -g_fSpinX, 0.0f, 1.0f, 0.0f );
+    int nMajor = 0;
+    int nMinor = 0;
 
-    if( g_bRenderInWireFrame == true )
-        glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
-    else
-        glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+    if( pVersion != NULL )
+        sscanf( pVersion, "%d.%d", &nMajor, &nMinor );
 
-    //
-    // Render test sphere...
-    //
+    g_bTimerQueries = nMajor > 3 || (nMajor == 3 && nMinor >= 3) ||
+                      (pExtensions != NULL && strstr( pExtensions, "GL_ARB_timer_query" ) != NULL);
 
-    glBindTexture( GL_TEXTURE_2D, g_textureID );
+    if( !g_bTimerQueries )
+        return;
 
-    if( g_nCurrentMode == IMMEDIATE_MODE )
-    {
-        // Render a textured sphere using immediate mode
+    glGenQueries( TIMER_QUERY_FRAMES, g_timerQueries );
 
-        // To be fair to immediate mode, we won't force it incur the overhead 
-        // of calling hundreds of math subroutines to generate a sphere each 
-        // frame, instead, we'll use the same array that we would use for 
-        // testing the vertex array, but we'll make the immediate mode calls 
-        // ourselves. This is more typical of how a real app would use 
-        // immediate mode calls.
+    for( int k = 0; k < TIMER_QUERY_FRAMES; ++k )
+        g_bTimerQueryPending[k] = false;
 
-        glBegin( GL_TRIANGLE_STRIP );
-        {
-            for( GLuint i = 0; i < g_nNumSphereVertices; ++i )
-            {
-                glNormal3f( (g_pSphereVertices+i)->nx,
-                            (g_pSphereVertices+i)->ny,
-                            (g_pSphereVertices+i)->nz );
+    g_nTimerQuery = 0;
+}
 
-                glTexCoord2f( (g_pSphereVertices+i)->tu,
-                              (g_pSphereVertices+i)->tv );
+//-----------------------------------------------------------------------------
+// Name: destroyFrameTimers()
+// Desc:
+//-----------------------------------------------------------------------------
+void destroyFrameTimers( void )
+{
+    if( g_bTimerQueries )
+        glDeleteQueries( TIMER_QUERY_FRAMES, g_timerQueries );
 
-                glVertex3f( (g_pSphereVertices+i)->vx,
-                            (g_pSphereVertices+i)->vy,
-                            (g_pSphereVertices+i)->vz );
-            }
-        }
-        glEnd();
-    }
+    g_bTimerQueries = false;
+}
 
-    if( g_nCurrentMode == DISPLAY_LIST )
-    {
-        // Render a textured sphere as a display list
-        glCallList( g_sphereDList );
-    }
+//-----------------------------------------------------------------------------
+// Name: beginFrameTimer()
+// Desc: Reads back the query this frame is about to reuse, issued
+//       TIMER_QUERY_FRAMES frames ago, and starts it again. If the GPU still
+//       hasn't finished that frame its time is dropped, since waiting for it
+//       would stall the very pipeline being measured.
+//-----------------------------------------------------------------------------
+void beginFrameTimer( void )
+{
+    if( !g_bTimerQueries )
+        return;
 
-    if( g_nCurrentMode == VERTEX_ARRAY )
+    if( g_bTimerQueryPending[g_nTimerQuery] )
     {
-        // Render a textured sphere using a vertex array
-        glInterleavedArrays( GL_T2F_N3F_V3F, 0, g_pSphereVertices );
-        glDrawArrays( GL_TRIANGLE_STRIP, 0, g_nNumSphereVertices );
+        GLint nAvailable = 0;
+        glGetQueryObjectiv( g_timerQueries[g_nTimerQuery], GL_QUERY_RESULT_AVAILABLE, &nAvailable );
+
+        if( nAvailable )
+            readFrameTimer( g_nTimerQuery );
+        else
+            ++g_nLateTimerQueries;
+
+        g_bTimerQueryPending[g_nTimerQuery] = false;
     }
 
-    if( g_bDoubleBuffered )
-        glXSwapBuffers( g_pDisplay, g_window ); // Buffer swap does implicit glFlush
-    else
-        glFlush(); // Explicit flush for single buffered case 
+    glBeginQuery( GL_TIME_ELAPSED, g_timerQueries[g_nTimerQuery] );
+}
+
+//-----------------------------------------------------------------------------
+// Name: endFrameTimer()
+// Desc:
+//-----------------------------------------------------------------------------
+void endFrameTimer( void )
+{
+    if( !g_bTimerQueries )
+        return;
+
+    glEndQuery( GL_TIME_ELAPSED );
+
+    g_bTimerQueryPending[g_nTimerQuery] = true;
+    g_nTimerQuery = (g_nTimerQuery + 1) % TIMER_QUERY_FRAMES;
 }
 
+//-----------------------------------------------------------------------------
+// Name: readFrameTimer()
+// Desc: Collects a query's time in milliseconds, if anyone's collecting.
+//-----------------------------------------------------------------------------
+void readFrameTimer( int nQuery )
+{
+    GLuint64 nTime = 0;
+    glGetQueryObjectui64v( g_timerQueries[nQuery], GL_QUERY_RESULT, &nTime );
+
+    if( g_pGPUFrameTimes != NULL && g_nNumGPUFrameTimes < g_nMaxGPUFrameTimes )
+        g_pGPUFrameTimes[g_nNumGPUFrameTimes++] = nTime / 1000000.0f;
+}
+
+//-----------------------------------------------------------------------------
+// Name: finishFrameTimers()
+// Desc: Waits for every query still in flight, oldest first. Only for use
+//       outside the timed frames.
+//-----------------------------------------------------------------------------
+void finishFrameTimers( void )
+{
+    if( !g_bTimerQueries )
+        return;
+
+    for( int k = 0; k < TIMER_QUERY_FRAMES; ++k )
+    {
+        int nQuery = (g_nTimerQuery + k) % TIMER_QUERY_FRAMES;
+
+        if( !g_bTimerQueryPending[nQuery] )
+            continue;
+
+        readFrameTimer( nQuery );
+        g_bTimerQueryPending[nQuery] = false;
+    }
+}
@@ -0,0 +1,204 @@
+//-----------------------------------------------------------------------------
+//           Name: mesh_file.cpp
+//    Description: See mesh_file.h
+//-----------------------------------------------------------------------------
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include "mesh_file.h"
+
+using namespace std;
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME        1099511628211ULL
+
+//-----------------------------------------------------------------------------
+// Name: alignMeshFileOffset()
+// Desc:
+//-----------------------------------------------------------------------------
+static uint64_t alignMeshFileOffset( uint64_t nOffset )
+{
+    return (nOffset + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
+}
+
+//-----------------------------------------------------------------------------
+// Name: writeAll()
+// Desc: pwrite() until every byte is out or it fails.
+//-----------------------------------------------------------------------------
+static bool writeAll( int fd, const void *pData, size_t nBytes, uint64_t nOffset )
+{
+    const char *pBytes = (const char *)pData;
+
+    while( nBytes > 0 )
+    {
+        ssize_t nWritten = pwrite( fd, pBytes, nBytes, (off_t)nOffset );
+
+        if( nWritten <= 0 )
+            return false;
+
+        pBytes  += nWritten;
+        nBytes  -= nWritten;
+        nOffset += nWritten;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getMeshFileChecksum()
+// Desc: FNV-1a, a 64-bit word at a time rather than a byte at a time, so
+//       checking a mapped file costs a fraction of generating it again.
+//       Chain calls by passing the last result back in, starting from 0.
+//-----------------------------------------------------------------------------
+uint64_t getMeshFileChecksum( const void *pData, size_t nBytes, uint64_t nChecksum )
+{
+    const unsigned char *pBytes = (const unsigned char *)pData;
+    uint64_t             nHash  = (nChecksum == 0) ? FNV_OFFSET_BASIS : nChecksum;
+
+    for( ; nBytes >= sizeof(uint64_t); nBytes -= sizeof(uint64_t), pBytes += sizeof(uint64_t) )
+    {
+        uint64_t nWord;
+        memcpy( &nWord, pBytes, sizeof(uint64_t) );
+
+        nHash = (nHash ^ nWord) * FNV_PRIME;
+    }
+
+    for( ; nBytes > 0; --nBytes, ++pBytes )
+        nHash = (nHash ^ *pBytes) * FNV_PRIME;
+
+    return nHash;
+}
+
+//-----------------------------------------------------------------------------
+// Name: writeMeshFile()
+// Desc: Writes the arrays described by pHeader, with the offsets and the
+//       checksum filled in. The file is written under a temporary name and
+//       renamed into place, so a reader never maps half a mesh.
+//-----------------------------------------------------------------------------
+bool writeMeshFile( const char *pFileName, const MeshFileHeader *pHeader,
+                    const void *pVertices, const void *pIndices )
+{
+    MeshFileHeader header = *pHeader;
+    size_t nVertexBytes   = (size_t)header.nNumVertices * header.nVertexSize;
+    size_t nIndexBytes    = (size_t)header.nNumIndices  * header.nIndexSize;
+
+    memcpy( header.szMagic, MESH_FILE_MAGIC, sizeof(header.szMagic) );
+    header.nVersion      = MESH_FILE_VERSION;
+    header.nVertexOffset = alignMeshFileOffset( sizeof(MeshFileHeader) );
+    header.nIndexOffset  = alignMeshFileOffset( header.nVertexOffset + nVertexBytes );
+    header.nChecksum     = getMeshFileChecksum( pVertices, nVertexBytes, 0 );
+    header.nChecksum     = getMeshFileChecksum( pIndices, nIndexBytes, header.nChecksum );
+
+    char szTempName[1024];
+    snprintf( szTempName, sizeof(szTempName), "%s.%d.tmp", pFileName, (int)getpid() );
+
+    int fd = open( szTempName, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+
+    if( fd < 0 )
+    {
+        cerr << "ERROR: writeMeshFile - Couldn't create " << szTempName << "." << endl;
+        return false;
+    }
+
+    bool bWritten = ftruncate( fd, (off_t)(header.nIndexOffset + nIndexBytes) ) == 0 &&
+                    writeAll( fd, &header, sizeof(header), 0 ) &&
+                    writeAll( fd, pVertices, nVertexBytes, header.nVertexOffset ) &&
+                    writeAll( fd, pIndices, nIndexBytes, header.nIndexOffset );
+
+    if( close( fd ) != 0 )
+        bWritten = false;
+
+    if( !bWritten || rename( szTempName, pFileName ) != 0 )
+    {
+        cerr << "ERROR: writeMeshFile - Couldn't write " << pFileName << "." << endl;
+        unlink( szTempName );
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: mapMeshFile()
+// Desc: Maps a file made by writeMeshFile() and copies its header to
+//       pHeader. The arrays are at the header's offsets from the returned
+//       address, and stay valid until unmapMeshFile(). The mapping is
+//       private, so writing to it never reaches the file. Returns NULL if
+//       there's no such file, or it's damaged or from another version.
+//-----------------------------------------------------------------------------
+void *mapMeshFile( const char *pFileName, MeshFileHeader *pHeader, size_t *pnBytes )
+{
+    int fd = open( pFileName, O_RDONLY );
+
+    if( fd < 0 )
+        return NULL;
+
+    struct stat info;
+
+    if( fstat( fd, &info ) != 0 || (size_t)info.st_size < sizeof(MeshFileHeader) )
+    {
+        close( fd );
+        return NULL;
+    }
+
+    size_t nBytes = (size_t)info.st_size;
+    void  *pFile  = mmap( NULL, nBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+
+    // The mapping holds its own reference to the file
+    close( fd );
+
+    if( pFile == MAP_FAILED )
+        return NULL;
+
+    memcpy( pHeader, pFile, sizeof(MeshFileHeader) );
+
+    size_t nVertexBytes = (size_t)pHeader->nNumVertices * pHeader->nVertexSize;
+    size_t nIndexBytes  = (size_t)pHeader->nNumIndices  * pHeader->nIndexSize;
+
+    // The sizes are checked against what's left after each offset, so a 
+    // damaged header can't overflow its way past the checks
+    bool bValid = memcmp( pHeader->szMagic, MESH_FILE_MAGIC, sizeof(pHeader->szMagic) ) == 0 &&
+                  pHeader->nVersion == MESH_FILE_VERSION &&
+                  pHeader->nVertexOffset >= sizeof(MeshFileHeader) &&
+                  pHeader->nVertexOffset <= pHeader->nIndexOffset &&
+                  pHeader->nIndexOffset <= nBytes &&
+                  nVertexBytes <= pHeader->nIndexOffset - pHeader->nVertexOffset &&
+                  nIndexBytes <= nBytes - pHeader->nIndexOffset;
+
+    if( bValid )
+    {
+        // The checksum reads the whole file anyway, so ask for it all at once
+        madvise( pFile, nBytes, MADV_WILLNEED );
+
+        uint64_t nChecksum = getMeshFileChecksum( (char *)pFile + pHeader->nVertexOffset, nVertexBytes, 0 );
+        nChecksum = getMeshFileChecksum( (char *)pFile + pHeader->nIndexOffset, nIndexBytes, nChecksum );
+
+        bValid = (nChecksum == pHeader->nChecksum);
+    }
+
+    if( !bValid )
+    {
+        cerr << "ERROR: mapMeshFile - " << pFileName << " is damaged or out of date." << endl;
+        munmap( pFile, nBytes );
+        return NULL;
+    }
+
+    *pnBytes = nBytes;
+
+    return pFile;
+}
+
+//-----------------------------------------------------------------------------
+// Name: unmapMeshFile()
+// Desc:
+//-----------------------------------------------------------------------------
+void unmapMeshFile( void *pFile, size_t nBytes )
+{
+    if( pFile != NULL )
+        munmap( pFile, nBytes );
+}
@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+//           Name: mesh_file.h
+//    Description: A binary file holding one generated sphere, so a mesh that
+//                 takes seconds to generate only has to be made once. The
+//                 header is followed by the raw vertex and index arrays,
+//                 each starting on a page boundary, so the file can be
+//                 mapped with mapMeshFile() and its arrays handed straight
+//                 to glBufferData() or the vertex array calls, with nothing
+//                 to parse or copy.
+//-----------------------------------------------------------------------------
+
+#ifndef _MESH_FILE_H_
+#define _MESH_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MESH_FILE_MAGIC   "SPHMESH"
+#define MESH_FILE_VERSION 1
+
+// Both arrays start on a multiple of this, counted from the file's start
+#define MESH_FILE_ALIGNMENT 4096
+
+struct MeshFileHeader
+{
+    char     szMagic[8];
+    uint32_t nVersion;
+
+    // What the mesh is, which the reader checks against what it asked for
+    uint32_t nLayout;
+    uint32_t nPrecision;
+    float    fRadius;
+
+    // Size in bytes of one vertex and one index
+    uint32_t nVertexSize;
+    uint32_t nNumVertices;
+    uint32_t nIndexSize;
+    uint32_t nNumIndices;
+    uint32_t nIndexPrimitive;
+
+    // The FIFO cache size the ACMR and ATVR were simulated with
+    uint32_t nCacheSize;
+    float    fACMR;
+    float    fATVR;
+
+    // Filled in by writeMeshFile(). The checksum covers both arrays.
+    uint64_t nVertexOffset;
+    uint64_t nIndexOffset;
+    uint64_t nChecksum;
+};
+
+bool  writeMeshFile( const char *pFileName, const MeshFileHeader *pHeader,
+                     const void *pVertices, const void *pIndices );
+
+void *mapMeshFile( const char *pFileName, MeshFileHeader *pHeader, size_t *pnBytes );
+void  unmapMeshFile( void *pFile, size_t nBytes );
+
+uint64_t getMeshFileChecksum( const void *pData, size_t nBytes, uint64_t nChecksum );
+
+#endif /* _MESH_FILE_H_ */
@@ -0,0 +1,249 @@
+//-----------------------------------------------------------------------------
+//           Name: sphere_kernels.cpp
+//    Description: See sphere_kernels.h
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+#include <stdlib.h>
+#include "sphere_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SPHERE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Name: createSphereTables()
+// Desc: Fills the per-column and per-ring vectors for a sphere centered at 
+//       cx, cy, cz with radius r and precision p.
+//-----------------------------------------------------------------------------
+void createSphereTables( SphereTables *pTables, 
+                         float cx, float cy, float cz, float r, int p )
+{
+    const float TWOPI  = 6.28318530717958f;
+    const float PIDIV2 = 1.57079632679489f;
+
+    pTables->nNumRings   = p/2 + 1;
+    pTables->nNumColumns = p + 1;
+    pTables->pColumns    = new float[pTables->nNumColumns * SPHERE_VERTEX_FLOATS];
+    pTables->pRingMul    = new float[pTables->nNumRings * SPHERE_VERTEX_FLOATS];
+    pTables->pRingAdd    = new float[pTables->nNumRings * SPHERE_VERTEX_FLOATS];
+
+    for( int j = 0; j < pTables->nNumColumns; ++j )
+    {
+        float  theta3 = j * TWOPI / p;
+        float  fCos   = cosf( theta3 );
+        float  fSin   = sinf( theta3 );
+        float *pCol   = pTables->pColumns + j * SPHERE_VERTEX_FLOATS;
+
+        pCol[0] = -(j/(float)p); // tu
+        pCol[1] = 0.0f;          // tv comes from the ring
+        pCol[2] = fCos;          // nx
+        pCol[3] = 1.0f;          // ny comes from the ring
+        pCol[4] = fSin;          // nz
+        pCol[5] = fCos;          // vx
+        pCol[6] = 1.0f;          // vy comes from the ring
+        pCol[7] = fSin;          // vz
+    }
+
+    for( int i = 0; i < pTables->nNumRings; ++i )
+    {
+        float  theta1 = i * TWOPI / p - PIDIV2;
+        float  fCos   = cosf( theta1 );
+        float  fSin   = sinf( theta1 );
+        float *pMul   = pTables->pRingMul + i * SPHERE_VERTEX_FLOATS;
+        float *pAdd   = pTables->pRingAdd + i * SPHERE_VERTEX_FLOATS;
+
+        pMul[0] = 1.0f;       pAdd[0] = 0.0f;
+        pMul[1] = 0.0f;       pAdd[1] = 2*i/(float)p;
+        pMul[2] = fCos;       pAdd[2] = 0.0f;
+        pMul[3] = fSin;       pAdd[3] = 0.0f;
+        pMul[4] = fCos;       pAdd[4] = 0.0f;
+        pMul[5] = r * fCos;   pAdd[5] = cx;
+        pMul[6] = r * fSin;   pAdd[6] = cy;
+        pMul[7] = r * fCos;   pAdd[7] = cz;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: destroySphereTables()
+// Desc: 
+//-----------------------------------------------------------------------------
+void destroySphereTables( SphereTables *pTables )
+{
+    delete []pTables->pColumns;
+    delete []pTables->pRingMul;
+    delete []pTables->pRingAdd;
+
+    pTables->pColumns = NULL;
+    pTables->pRingMul = NULL;
+    pTables->pRingAdd = NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getSphereVertex()
+// Desc: Computes a single vertex, for callers that don't want a whole ring.
+//-----------------------------------------------------------------------------
+void getSphereVertex( const SphereTables *pTables, int nRing, int nColumn, 
+                      float *pOut )
+{
+    const float *pCol = pTables->pColumns + nColumn * SPHERE_VERTEX_FLOATS;
+    const float *pMul = pTables->pRingMul + nRing * SPHERE_VERTEX_FLOATS;
+    const float *pAdd = pTables->pRingAdd + nRing * SPHERE_VERTEX_FLOATS;
+
+    for( int k = 0; k < SPHERE_VERTEX_FLOATS; ++k )
+        pOut[k] = pCol[k] * pMul[k] + pAdd[k];
+}
+
+//-----------------------------------------------------------------------------
+// Name: writeSphereRingScalar()
+// Desc: Plain C kernel, used where no SIMD kernel is available.
+//-----------------------------------------------------------------------------
+static void writeSphereRingScalar( const SphereTables *pTables, int nRing, 
+                                   float *pOut, int nStride )
+{
+    const float *pMul = pTables->pRingMul + nRing * SPHERE_VERTEX_FLOATS;
+    const float *pAdd = pTables->pRingAdd + nRing * SPHERE_VERTEX_FLOATS;
+
+    for( int j = 0; j < pTables->nNumColumns; ++j )
+    {
+        const float *pCol    = pTables->pColumns + j * SPHERE_VERTEX_FLOATS;
+        float       *pVertex = pOut + j * nStride * SPHERE_VERTEX_FLOATS;
+
+        for( int k = 0; k < SPHERE_VERTEX_FLOATS; ++k )
+            pVertex[k] = pCol[k] * pMul[k] + pAdd[k];
+    }
+}
+
+#ifdef SPHERE_KERNELS_X86
+
+//-----------------------------------------------------------------------------
+// Name: writeSphereRingSSE()
+// Desc: Writes each vertex as two 4 float halves.
+//-----------------------------------------------------------------------------
+__attribute__((target("sse")))
+static void writeSphereRingSSE( const SphereTables *pTables, int nRing, 
+                                float *pOut, int nStride )
+{
+    const float *pMul = pTables->pRingMul + nRing * SPHERE_VERTEX_FLOATS;
+    const float *pAdd = pTables->pRingAdd + nRing * SPHERE_VERTEX_FLOATS;
+
+    __m128 mulLo = _mm_loadu_ps( pMul );
+    __m128 mulHi = _mm_loadu_ps( pMul + 4 );
+    __m128 addLo = _mm_loadu_ps( pAdd );
+    __m128 addHi = _mm_loadu_ps( pAdd + 4 );
+
+    for( int j = 0; j < pTables->nNumColumns; ++j )
+    {
+        const float *pCol    = pTables->pColumns + j * SPHERE_VERTEX_FLOATS;
+        float       *pVertex = pOut + j * nStride * SPHERE_VERTEX_FLOATS;
+
+        _mm_storeu_ps( pVertex,     _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( pCol ), mulLo ), addLo ) );
+        _mm_storeu_ps( pVertex + 4, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( pCol + 4 ), mulHi ), addHi ) );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: writeSphereRingAVX()
+// Desc: A whole 32 byte vertex fits in one AVX register.
+//-----------------------------------------------------------------------------
+__attribute__((target("avx")))
+static void writeSphereRingAVX( const SphereTables *pTables, int nRing, 
+                                float *pOut, int nStride )
+{
+    const float *pMul = pTables->pRingMul + nRing * SPHERE_VERTEX_FLOATS;
+    const float *pAdd = pTables->pRingAdd + nRing * SPHERE_VERTEX_FLOATS;
+
+    __m256 mul = _mm256_loadu_ps( pMul );
+    __m256 add = _mm256_loadu_ps( pAdd );
+
+    for( int j = 0; j < pTables->nNumColumns; ++j )
+    {
+        const float *pCol    = pTables->pColumns + j * SPHERE_VERTEX_FLOATS;
+        float       *pVertex = pOut + j * nStride * SPHERE_VERTEX_FLOATS;
+
+        _mm256_storeu_ps( pVertex, _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( pCol ), mul ), add ) );
+    }
+}
+
+#endif /* SPHERE_KERNELS_X86 */
+
+//-----------------------------------------------------------------------------
+// Name: writeSphereRing()
+// Desc: Writes every column of ring nRing, nStride vertices apart, starting 
+//       at pOut. The strip layout interleaves two rings with a stride of 2, 
+//       the indexed layouts store one ring after another with a stride of 1.
+//-----------------------------------------------------------------------------
+void writeSphereRing( const SphereTables *pTables, int nRing, 
+                      float *pOut, int nStride, int nKernel )
+{
+#ifdef SPHERE_KERNELS_X86
+    if( nKernel == SPHERE_KERNEL_AVX )
+    {
+        writeSphereRingAVX( pTables, nRing, pOut, nStride );
+        return;
+    }
+
+    if( nKernel == SPHERE_KERNEL_SSE )
+    {
+        writeSphereRingSSE( pTables, nRing, pOut, nStride );
+        return;
+    }
+#endif
+
+    writeSphereRingScalar( pTables, nRing, pOut, nStride );
+}
+
+//-----------------------------------------------------------------------------
+// Name: isSphereKernelSupported()
+// Desc: Whether this build and this CPU can run a kernel.
+//-----------------------------------------------------------------------------
+bool isSphereKernelSupported( int nKernel )
+{
+    switch( nKernel )
+    {
+        case SPHERE_KERNEL_SCALAR: 
+            return true;
+
+#ifdef SPHERE_KERNELS_X86
+        case SPHERE_KERNEL_SSE:
+            return __builtin_cpu_supports( "sse" );
+
+        case SPHERE_KERNEL_AVX:
+            return __builtin_cpu_supports( "avx" );
+#endif
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getBestSphereKernel()
+// Desc: The widest kernel the CPU supports.
+//-----------------------------------------------------------------------------
+int getBestSphereKernel( void )
+{
+    for( int nKernel = NUM_SPHERE_KERNELS - 1; nKernel > SPHERE_KERNEL_SCALAR; --nKernel )
+    {
+        if( isSphereKernelSupported( nKernel ) )
+            return nKernel;
+    }
+
+    return SPHERE_KERNEL_SCALAR;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getSphereKernelKey()
+// Desc: 
+//-----------------------------------------------------------------------------
+const char *getSphereKernelKey( int nKernel )
+{
+    switch( nKernel )
+    {
+        case SPHERE_KERNEL_SCALAR: return "scalar";
+        case SPHERE_KERNEL_SSE:    return "sse";
+        case SPHERE_KERNEL_AVX:    return "avx";
+    }
+
+    return "unknown";
+}
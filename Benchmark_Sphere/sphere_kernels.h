@@ -0,0 +1,57 @@
+//-----------------------------------------------------------------------------
+//           Name: sphere_kernels.h
+//    Description: Fast generation of the sphere's GL_T2F_N3F_V3F vertices.
+//
+//                 Every vertex of ring i, column j is
+//
+//                   tu = -j/p
+//                   tv = 2i/p
+//                   n  = ( cos(theta_i) * cos(theta_j), 
+//                          sin(theta_i), 
+//                          cos(theta_i) * sin(theta_j) )
+//                   v  = c + r * n
+//
+//                 so it can be written as col[j] * mul[i] + add[i], where 
+//                 the three 8 float vectors only depend on the column or on 
+//                 the ring. createSphereTables() computes them once, with one
+//                 sinf/cosf pair per ring and per column, and the kernels 
+//                 then write each vertex with a single multiply-add across 
+//                 all 8 floats. An AVX, an SSE and a plain C kernel are 
+//                 provided, and getBestSphereKernel() picks one at runtime.
+//-----------------------------------------------------------------------------
+
+#ifndef _SPHERE_KERNELS_H_
+#define _SPHERE_KERNELS_H_
+
+#define SPHERE_KERNEL_SCALAR 0
+#define SPHERE_KERNEL_SSE    1
+#define SPHERE_KERNEL_AVX    2
+
+#define NUM_SPHERE_KERNELS 3
+
+// Floats per vertex, laid out as tu, tv, nx, ny, nz, vx, vy, vz
+#define SPHERE_VERTEX_FLOATS 8
+
+struct SphereTables
+{
+    int    nNumRings;   // (p/2) + 1
+    int    nNumColumns; // p + 1
+    float *pColumns;    // 8 floats per column
+    float *pRingMul;    // 8 floats per ring
+    float *pRingAdd;    // 8 floats per ring
+};
+
+void createSphereTables( SphereTables *pTables, 
+                         float cx, float cy, float cz, float r, int p );
+void destroySphereTables( SphereTables *pTables );
+
+void writeSphereRing( const SphereTables *pTables, int nRing, 
+                      float *pOut, int nStride, int nKernel );
+void getSphereVertex( const SphereTables *pTables, int nRing, int nColumn, 
+                      float *pOut );
+
+int getBestSphereKernel( void );
+bool isSphereKernelSupported( int nKernel );
+const char *getSphereKernelKey( int nKernel );
+
+#endif /* _SPHERE_KERNELS_H_ */
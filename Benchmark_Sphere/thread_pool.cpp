@@ -0,0 +1,213 @@
+//-----------------------------------------------------------------------------
+//           Name: thread_pool.cpp
+//    Description: See thread_pool.h
+//-----------------------------------------------------------------------------
+
+#include <pthread.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <iostream>
+#include "thread_pool.h"
+
+using namespace std;
+
+// Items are handed out a few at a time, so a slow thread can't hold up the 
+// whole job with one large slice.
+#define ITEMS_PER_GRAB 4
+
+static pthread_t      *s_pWorkers    = NULL;
+static int             s_nNumWorkers = 0;
+static pthread_mutex_t s_mutex       = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  s_workReady   = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  s_workDone    = PTHREAD_COND_INITIALIZER;
+static bool            s_bQuit       = false;
+
+// Held for the whole of a job, so jobs posted from different threads take
+// turns instead of trampling each other's state
+static pthread_mutex_t s_jobMutex    = PTHREAD_MUTEX_INITIALIZER;
+
+// The job being run, s_nJobNumber changes every time a new one is posted
+static ThreadPoolJob   s_pfnJob      = NULL;
+static void           *s_pJobData    = NULL;
+static int             s_nNumItems   = 0;
+static int             s_nNextItem   = 0;
+static int             s_nJobWorkers = 0;
+static int             s_nBusy       = 0;
+static unsigned int    s_nJobNumber  = 0;
+
+//-----------------------------------------------------------------------------
+// Name: doJobItems()
+// Desc: Grabs items off the current job until there are none left.
+//-----------------------------------------------------------------------------
+static void doJobItems( void )
+{
+    for( ;; )
+    {
+        int nFirst = __sync_fetch_and_add( &s_nNextItem, ITEMS_PER_GRAB );
+
+        if( nFirst >= s_nNumItems )
+            break;
+
+        int nLast = nFirst + ITEMS_PER_GRAB;
+
+        if( nLast > s_nNumItems )
+            nLast = s_nNumItems;
+
+        s_pfnJob( s_pJobData, nFirst, nLast );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: workerMain()
+// Desc: Sleeps until a job is posted, and helps with it if it asked for 
+//       this many threads.
+//-----------------------------------------------------------------------------
+static void *workerMain( void *pArg )
+{
+    int          nWorker      = (int)(size_t)pArg;
+    unsigned int nLastJob     = 0;
+
+    pthread_mutex_lock( &s_mutex );
+
+    for( ;; )
+    {
+        while( !s_bQuit && s_nJobNumber == nLastJob )
+            pthread_cond_wait( &s_workReady, &s_mutex );
+
+        if( s_bQuit )
+            break;
+
+        nLastJob = s_nJobNumber;
+
+        if( nWorker >= s_nJobWorkers )
+            continue;
+
+        pthread_mutex_unlock( &s_mutex );
+        doJobItems();
+        pthread_mutex_lock( &s_mutex );
+
+        if( --s_nBusy == 0 )
+            pthread_cond_signal( &s_workDone );
+    }
+
+    pthread_mutex_unlock( &s_mutex );
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: createThreadPool()
+// Desc: Starts nNumThreads-1 workers. Returns false if none of them could be
+//       started, in which case jobs simply run on the calling thread.
+//-----------------------------------------------------------------------------
+bool createThreadPool( int nNumThreads )
+{
+    destroyThreadPool();
+
+    if( nNumThreads < 2 )
+        return true;
+
+    s_pWorkers = new pthread_t[nNumThreads - 1];
+    s_bQuit    = false;
+
+    for( int i = 0; i < nNumThreads - 1; ++i )
+    {
+        if( pthread_create( &s_pWorkers[i], NULL, workerMain, (void *)(size_t)i ) != 0 )
+        {
+            cerr << "ERROR: createThreadPool - Only " << i + 1 << " of " 
+                 << nNumThreads << " threads could be started." << endl;
+            break;
+        }
+
+        ++s_nNumWorkers;
+    }
+
+    return s_nNumWorkers > 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: destroyThreadPool()
+// Desc: 
+//-----------------------------------------------------------------------------
+void destroyThreadPool( void )
+{
+    if( s_pWorkers == NULL )
+        return;
+
+    pthread_mutex_lock( &s_mutex );
+    s_bQuit = true;
+    pthread_cond_broadcast( &s_workReady );
+    pthread_mutex_unlock( &s_mutex );
+
+    for( int i = 0; i < s_nNumWorkers; ++i )
+        pthread_join( s_pWorkers[i], NULL );
+
+    delete []s_pWorkers;
+    s_pWorkers    = NULL;
+    s_nNumWorkers = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getThreadPoolSize()
+// Desc: Threads a job can run on, counting the calling thread.
+//-----------------------------------------------------------------------------
+int getThreadPoolSize( void )
+{
+    return s_nNumWorkers + 1;
+}
+
+//-----------------------------------------------------------------------------
+// Name: getNumProcessors()
+// Desc: 
+//-----------------------------------------------------------------------------
+int getNumProcessors( void )
+{
+    long nNumProcessors = sysconf( _SC_NPROCESSORS_ONLN );
+
+    return (nNumProcessors < 1) ? 1 : (int)nNumProcessors;
+}
+
+//-----------------------------------------------------------------------------
+// Name: runThreadPoolJob()
+// Desc: Runs pfnJob over items 0 to nNumItems-1 on up to nNumThreads 
+//       threads, and returns once every item is done. Can be called from 
+//       any thread, but a job waits for any other thread's job to finish 
+//       before it starts.
+//-----------------------------------------------------------------------------
+void runThreadPoolJob( ThreadPoolJob pfnJob, void *pData, 
+                       int nNumItems, int nNumThreads )
+{
+    int nJobWorkers = nNumThreads - 1;
+
+    if( nJobWorkers > s_nNumWorkers )
+        nJobWorkers = s_nNumWorkers;
+
+    // Not worth waking anyone up for
+    if( nJobWorkers < 1 || nNumItems <= ITEMS_PER_GRAB )
+    {
+        pfnJob( pData, 0, nNumItems );
+        return;
+    }
+
+    pthread_mutex_lock( &s_jobMutex );
+    pthread_mutex_lock( &s_mutex );
+    s_pfnJob      = pfnJob;
+    s_pJobData    = pData;
+    s_nNumItems   = nNumItems;
+    s_nNextItem   = 0;
+    s_nJobWorkers = nJobWorkers;
+    s_nBusy       = nJobWorkers;
+    ++s_nJobNumber;
+    pthread_cond_broadcast( &s_workReady );
+    pthread_mutex_unlock( &s_mutex );
+
+    doJobItems();
+
+    pthread_mutex_lock( &s_mutex );
+
+    while( s_nBusy > 0 )
+        pthread_cond_wait( &s_workDone, &s_mutex );
+
+    pthread_mutex_unlock( &s_mutex );
+    pthread_mutex_unlock( &s_jobMutex );
+}
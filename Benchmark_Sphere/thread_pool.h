@@ -0,0 +1,23 @@
+//-----------------------------------------------------------------------------
+//           Name: thread_pool.h
+//    Description: A small pool of POSIX threads for splitting a loop of 
+//                 independent items, such as the bands of the sphere, 
+//                 across every core. The calling thread works on the job 
+//                 too, so a pool of N threads only starts N-1 workers.
+//-----------------------------------------------------------------------------
+
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+// Processes items nFirst up to, but not including, nLast
+typedef void (*ThreadPoolJob)( void *pData, int nFirst, int nLast );
+
+bool createThreadPool( int nNumThreads );
+void destroyThreadPool( void );
+int  getThreadPoolSize( void );
+int  getNumProcessors( void );
+
+void runThreadPoolJob( ThreadPoolJob pfnJob, void *pData, 
+                       int nNumItems, int nNumThreads );
+
+#endif /* _THREAD_POOL_H_ */
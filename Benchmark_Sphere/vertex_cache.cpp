@@ -0,0 +1,246 @@
+//-----------------------------------------------------------------------------
+//           Name: vertex_cache.cpp
+//    Description: See vertex_cache.h
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+#include <string.h>
+#include "vertex_cache.h"
+
+//-----------------------------------------------------------------------------
+// Name: getVertexScore()
+// Desc: Forsyth's vertex score. Vertices that were just used, or that have 
+//       few triangles left to draw, score higher.
+//-----------------------------------------------------------------------------
+static float getVertexScore( int nCachePosition, int nRemainingValence )
+{
+    const float fCacheDecayPower   = 1.5f;
+    const float fLastTriScore      = 0.75f;
+    const float fValenceBoostScale = 2.0f;
+    const float fValenceBoostPower = 0.5f;
+
+    // Nothing left to draw with this vertex
+    if( nRemainingValence == 0 )
+        return -1.0f;
+
+    float fScore = 0.0f;
+
+    if( nCachePosition >= 0 )
+    {
+        if( nCachePosition < 3 )
+        {
+            // The vertex was used by the last triangle. Deliberately score it
+            // a little lower than the next ones, so the optimizer doesn't 
+            // just ping-pong between the same two triangles.
+            fScore = fLastTriScore;
+        }
+        else
+        {
+            const float fScaler = 1.0f / (VERTEX_CACHE_SCORE_SIZE - 3);
+            fScore = 1.0f - (nCachePosition - 3) * fScaler;
+            fScore = powf( fScore, fCacheDecayPower );
+        }
+    }
+
+    // Bonus for vertices with few triangles left, so lone triangles get 
+    // picked up before they turn into expensive stragglers.
+    fScore += fValenceBoostScale * powf( (float)nRemainingValence, -fValenceBoostPower );
+
+    return fScore;
+}
+
+//-----------------------------------------------------------------------------
+// Name: optimizeVertexCache()
+// Desc: Reorders, in place, the triangles of an indexed GL_TRIANGLES list so
+//       that vertices are reused while they are still in the cache. The 
+//       winding of every triangle is preserved.
+//-----------------------------------------------------------------------------
+void optimizeVertexCache( GLuint *pIndices, int nNumIndices, int nNumVertices )
+{
+    int nNumTriangles = nNumIndices / 3;
+
+    if( nNumTriangles == 0 )
+        return;
+
+    int    *pValence       = new int[nNumVertices];
+    int    *pOffsets       = new int[nNumVertices];
+    int    *pTriangles     = new int[nNumIndices];
+    int    *pCachePosition = new int[nNumVertices];
+    float  *pVertexScore   = new float[nNumVertices];
+    bool   *pAdded         = new bool[nNumTriangles];
+    GLuint *pOutput        = new GLuint[nNumIndices];
+
+    //
+    // Build the list of triangles using each vertex. The first 
+    // pValence[v] entries from pOffsets[v] are the ones not yet drawn.
+    //
+
+    memset( pValence, 0, nNumVertices * sizeof(int) );
+    memset( pAdded, 0, nNumTriangles * sizeof(bool) );
+
+    for( int i = 0; i < nNumIndices; ++i )
+        ++pValence[pIndices[i]];
+
+    int nOffset = 0;
+
+    for( int v = 0; v < nNumVertices; ++v )
+    {
+        pOffsets[v] = nOffset;
+        nOffset    += pValence[v];
+        pValence[v] = 0;
+    }
+
+    for( int i = 0; i < nNumIndices; ++i )
+    {
+        GLuint v = pIndices[i];
+        pTriangles[pOffsets[v] + pValence[v]++] = i / 3;
+    }
+
+    for( int v = 0; v < nNumVertices; ++v )
+    {
+        pCachePosition[v] = -1;
+        pVertexScore[v]   = getVertexScore( -1, pValence[v] );
+    }
+
+    //
+    // Greedily add the best scoring triangle among those touching the 
+    // cache. When none is left, fall back to the next triangle in the 
+    // original order.
+    //
+
+    int nCache[VERTEX_CACHE_SCORE_SIZE + 3];
+    int nCacheSize    = 0;
+    int nBestTriangle = -1;
+    int nScanCursor   = 0;
+
+    for( int t = 0; t < nNumTriangles; ++t )
+    {
+        if( nBestTriangle < 0 )
+        {
+            while( pAdded[nScanCursor] )
+                ++nScanCursor;
+
+            nBestTriangle = nScanCursor;
+        }
+
+        pAdded[nBestTriangle] = true;
+
+        GLuint *pTriangle = pIndices + nBestTriangle * 3;
+
+        pOutput[t * 3 + 0] = pTriangle[0];
+        pOutput[t * 3 + 1] = pTriangle[1];
+        pOutput[t * 3 + 2] = pTriangle[2];
+
+        // Remove the triangle from each of its vertices' lists
+        for( int k = 0; k < 3; ++k )
+        {
+            GLuint v     = pTriangle[k];
+            int   *pList = pTriangles + pOffsets[v];
+
+            for( int n = 0; n < pValence[v]; ++n )
+            {
+                if( pList[n] == nBestTriangle )
+                {
+                    pList[n] = pList[pValence[v] - 1];
+                    break;
+                }
+            }
+
+            --pValence[v];
+        }
+
+        // Move the triangle's vertices to the front of the LRU cache
+        int nNewCache[VERTEX_CACHE_SCORE_SIZE + 3];
+        int nNewCacheSize = 0;
+
+        for( int k = 0; k < 3; ++k )
+            nNewCache[nNewCacheSize++] = pTriangle[k];
+
+        for( int n = 0; n < nCacheSize; ++n )
+        {
+            int v = nCache[n];
+
+            if( v != (int)pTriangle[0] && v != (int)pTriangle[1] && v != (int)pTriangle[2] )
+            {
+                if( nNewCacheSize < VERTEX_CACHE_SCORE_SIZE + 3 )
+                    nNewCache[nNewCacheSize++] = v;
+            }
+        }
+
+        // Anything pushed past the scored size has fallen out of the cache
+        for( int n = 0; n < nNewCacheSize; ++n )
+        {
+            int v = nNewCache[n];
+
+            pCachePosition[v] = (n < VERTEX_CACHE_SCORE_SIZE) ? n : -1;
+            pVertexScore[v]   = getVertexScore( pCachePosition[v], pValence[v] );
+        }
+
+        nCacheSize = (nNewCacheSize < VERTEX_CACHE_SCORE_SIZE) ? nNewCacheSize : VERTEX_CACHE_SCORE_SIZE;
+        memcpy( nCache, nNewCache, nCacheSize * sizeof(int) );
+
+        // Pick the next triangle among those using a cached vertex
+        float fBestScore = -1.0f;
+        nBestTriangle    = -1;
+
+        for( int n = 0; n < nCacheSize; ++n )
+        {
+            int  v     = nCache[n];
+            int *pList = pTriangles + pOffsets[v];
+
+            for( int m = 0; m < pValence[v]; ++m )
+            {
+                GLuint *pCandidate = pIndices + pList[m] * 3;
+                float   fScore     = pVertexScore[pCandidate[0]] + 
+                                     pVertexScore[pCandidate[1]] + 
+                                     pVertexScore[pCandidate[2]];
+
+                if( fScore > fBestScore )
+                {
+                    fBestScore    = fScore;
+                    nBestTriangle = pList[m];
+                }
+            }
+        }
+    }
+
+    memcpy( pIndices, pOutput, nNumTriangles * 3 * sizeof(GLuint) );
+
+    delete []pValence;
+    delete []pOffsets;
+    delete []pTriangles;
+    delete []pCachePosition;
+    delete []pVertexScore;
+    delete []pAdded;
+    delete []pOutput;
+}
+
+//-----------------------------------------------------------------------------
+// Name: simulateVertexCache()
+// Desc: Runs an index stream through a FIFO post-transform cache holding 
+//       nCacheSize vertices, and returns the number of misses, which is the 
+//       number of vertices that would have to be transformed. A hit does not
+//       refresh a vertex's place in a FIFO cache, so a vertex is cached 
+//       exactly when it was one of the last nCacheSize misses.
+//-----------------------------------------------------------------------------
+int simulateVertexCache( const GLuint *pIndices, int nNumIndices, 
+                         int nNumVertices, int nCacheSize )
+{
+    int *pMissNumber = new int[nNumVertices];
+    int  nNumMisses  = 0;
+
+    for( int v = 0; v < nNumVertices; ++v )
+        pMissNumber[v] = -1;
+
+    for( int i = 0; i < nNumIndices; ++i )
+    {
+        GLuint v = pIndices[i];
+
+        if( pMissNumber[v] < 0 || nNumMisses - pMissNumber[v] >= nCacheSize )
+            pMissNumber[v] = ++nNumMisses;
+    }
+
+    delete []pMissNumber;
+
+    return nNumMisses;
+}
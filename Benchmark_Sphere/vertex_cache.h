@@ -0,0 +1,29 @@
+//-----------------------------------------------------------------------------
+//           Name: vertex_cache.h
+//    Description: Post-transform vertex cache utilities for indexed meshes. 
+//                 optimizeVertexCache() reorders the triangles of an indexed 
+//                 triangle list using Tom Forsyth's "Linear-Speed Vertex 
+//                 Cache Optimisation", and simulateVertexCache() counts the 
+//                 transforms a FIFO cache of a given size would need, from 
+//                 which the ACMR and ATVR are derived.
+//
+//                 ACMR - Average Cache Miss Ratio, transforms per triangle.
+//                        0.5 is the ideal for a large regular mesh.
+//                 ATVR - Average Transformed Vertex Ratio, transforms per 
+//                        vertex. 1.0 is the ideal.
+//-----------------------------------------------------------------------------
+
+#ifndef _VERTEX_CACHE_H_
+#define _VERTEX_CACHE_H_
+
+#include <GL/gl.h>
+
+// Size of the LRU cache the optimizer scores vertices against
+#define VERTEX_CACHE_SCORE_SIZE 32
+
+void optimizeVertexCache( GLuint *pIndices, int nNumIndices, int nNumVertices );
+
+int simulateVertexCache( const GLuint *pIndices, int nNumIndices, 
+                         int nNumVertices, int nCacheSize );
+
+#endif /* _VERTEX_CACHE_H_ */
@@ -0,0 +1,278 @@
+//-----------------------------------------------------------------------------
+//           Name: vertex_transform.cpp
+//    Description: See vertex_transform.h
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+#include "sphere_kernels.h"
+#include "vertex_transform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VERTEX_TRANSFORM_X86
+#include <immintrin.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Name: transformVertexScalar()
+// Desc: Transforms a single vertex, for the plain C kernel and for whatever
+//       is left over after the SIMD kernels' last whole batch.
+//-----------------------------------------------------------------------------
+static inline void transformVertexScalar( const float *m, const float *n,
+                                          const float *pIn, float *pOut )
+{
+    float nx = pIn[2], ny = pIn[3], nz = pIn[4];
+    float vx = pIn[5], vy = pIn[6], vz = pIn[7];
+
+    pOut[0] = m[0]*vx + m[4]*vy + m[8]*vz  + m[12];
+    pOut[1] = m[1]*vx + m[5]*vy + m[9]*vz  + m[13];
+    pOut[2] = m[2]*vx + m[6]*vy + m[10]*vz + m[14];
+    pOut[3] = m[3]*vx + m[7]*vy + m[11]*vz + m[15];
+    pOut[4] = n[0]*nx + n[3]*ny + n[6]*nz;
+    pOut[5] = n[1]*nx + n[4]*ny + n[7]*nz;
+    pOut[6] = n[2]*nx + n[5]*ny + n[8]*nz;
+    pOut[7] = 0.0f;
+}
+
+//-----------------------------------------------------------------------------
+// Name: transformVerticesScalar()
+// Desc: Plain C kernel, used where no SIMD kernel is available.
+//-----------------------------------------------------------------------------
+static void transformVerticesScalar( const float *m, const float *n,
+                                     const float *pIn, float *pOut, int nNumVertices )
+{
+    for( int i = 0; i < nNumVertices; ++i )
+    {
+        transformVertexScalar( m, n, pIn  + i * SPHERE_VERTEX_FLOATS,
+                                     pOut + i * TRANSFORMED_VERTEX_FLOATS );
+    }
+}
+
+#ifdef VERTEX_TRANSFORM_X86
+
+//-----------------------------------------------------------------------------
+// Name: transformVerticesSSE()
+// Desc: Four vertices at a time. Each vertex is loaded as two 4 float
+//       halves, and transposing the four first halves and the four second
+//       halves gives tu, tv, nx, ny and nz, vx, vy, vz of all four.
+//-----------------------------------------------------------------------------
+__attribute__((target("sse")))
+static void transformVerticesSSE( const float *m, const float *n,
+                                  const float *pIn, float *pOut, int nNumVertices )
+{
+    __m128 am[16], an[9];
+
+    for( int k = 0; k < 16; ++k )
+        am[k] = _mm_set1_ps( m[k] );
+
+    for( int k = 0; k < 9; ++k )
+        an[k] = _mm_set1_ps( n[k] );
+
+    int i = 0;
+
+    for( ; i + 4 <= nNumVertices; i += 4 )
+    {
+        const float *pBatch = pIn + i * SPHERE_VERTEX_FLOATS;
+
+        __m128 tu = _mm_loadu_ps( pBatch );
+        __m128 tv = _mm_loadu_ps( pBatch + SPHERE_VERTEX_FLOATS );
+        __m128 nx = _mm_loadu_ps( pBatch + SPHERE_VERTEX_FLOATS*2 );
+        __m128 ny = _mm_loadu_ps( pBatch + SPHERE_VERTEX_FLOATS*3 );
+        __m128 nz = _mm_loadu_ps( pBatch + 4 );
+        __m128 vx = _mm_loadu_ps( pBatch + SPHERE_VERTEX_FLOATS + 4 );
+        __m128 vy = _mm_loadu_ps( pBatch + SPHERE_VERTEX_FLOATS*2 + 4 );
+        __m128 vz = _mm_loadu_ps( pBatch + SPHERE_VERTEX_FLOATS*3 + 4 );
+
+        _MM_TRANSPOSE4_PS( tu, tv, nx, ny );
+        _MM_TRANSPOSE4_PS( nz, vx, vy, vz );
+
+        __m128 x = _mm_add_ps( _mm_add_ps( _mm_mul_ps( am[0], vx ), _mm_mul_ps( am[4], vy ) ),
+                               _mm_add_ps( _mm_mul_ps( am[8], vz ), am[12] ) );
+        __m128 y = _mm_add_ps( _mm_add_ps( _mm_mul_ps( am[1], vx ), _mm_mul_ps( am[5], vy ) ),
+                               _mm_add_ps( _mm_mul_ps( am[9], vz ), am[13] ) );
+        __m128 z = _mm_add_ps( _mm_add_ps( _mm_mul_ps( am[2], vx ), _mm_mul_ps( am[6], vy ) ),
+                               _mm_add_ps( _mm_mul_ps( am[10], vz ), am[14] ) );
+        __m128 w = _mm_add_ps( _mm_add_ps( _mm_mul_ps( am[3], vx ), _mm_mul_ps( am[7], vy ) ),
+                               _mm_add_ps( _mm_mul_ps( am[11], vz ), am[15] ) );
+
+        __m128 ex = _mm_add_ps( _mm_add_ps( _mm_mul_ps( an[0], nx ), _mm_mul_ps( an[3], ny ) ),
+                                _mm_mul_ps( an[6], nz ) );
+        __m128 ey = _mm_add_ps( _mm_add_ps( _mm_mul_ps( an[1], nx ), _mm_mul_ps( an[4], ny ) ),
+                                _mm_mul_ps( an[7], nz ) );
+        __m128 ez = _mm_add_ps( _mm_add_ps( _mm_mul_ps( an[2], nx ), _mm_mul_ps( an[5], ny ) ),
+                                _mm_mul_ps( an[8], nz ) );
+        __m128 ew = _mm_setzero_ps();
+
+        _MM_TRANSPOSE4_PS( x, y, z, w );
+        _MM_TRANSPOSE4_PS( ex, ey, ez, ew );
+
+        float *pOutBatch = pOut + i * TRANSFORMED_VERTEX_FLOATS;
+
+        _mm_storeu_ps( pOutBatch,                                   x );
+        _mm_storeu_ps( pOutBatch + 4,                               ex );
+        _mm_storeu_ps( pOutBatch + TRANSFORMED_VERTEX_FLOATS,       y );
+        _mm_storeu_ps( pOutBatch + TRANSFORMED_VERTEX_FLOATS + 4,   ey );
+        _mm_storeu_ps( pOutBatch + TRANSFORMED_VERTEX_FLOATS*2,     z );
+        _mm_storeu_ps( pOutBatch + TRANSFORMED_VERTEX_FLOATS*2 + 4, ez );
+        _mm_storeu_ps( pOutBatch + TRANSFORMED_VERTEX_FLOATS*3,     w );
+        _mm_storeu_ps( pOutBatch + TRANSFORMED_VERTEX_FLOATS*3 + 4, ew );
+    }
+
+    transformVerticesScalar( m, n, pIn  + i * SPHERE_VERTEX_FLOATS,
+                                   pOut + i * TRANSFORMED_VERTEX_FLOATS, nNumVertices - i );
+}
+
+//-----------------------------------------------------------------------------
+// Name: transpose8x8()
+// Desc: Turns eight rows of 8 floats into eight columns, in place.
+//-----------------------------------------------------------------------------
+__attribute__((target("avx")))
+static inline void transpose8x8( __m256 *r )
+{
+    __m256 t[8], s[8];
+
+    for( int k = 0; k < 8; k += 2 )
+    {
+        t[k]     = _mm256_unpacklo_ps( r[k], r[k + 1] );
+        t[k + 1] = _mm256_unpackhi_ps( r[k], r[k + 1] );
+    }
+
+    for( int k = 0; k < 8; k += 4 )
+    {
+        s[k]     = _mm256_shuffle_ps( t[k],     t[k + 2], 0x44 );
+        s[k + 1] = _mm256_shuffle_ps( t[k],     t[k + 2], 0xEE );
+        s[k + 2] = _mm256_shuffle_ps( t[k + 1], t[k + 3], 0x44 );
+        s[k + 3] = _mm256_shuffle_ps( t[k + 1], t[k + 3], 0xEE );
+    }
+
+    for( int k = 0; k < 4; ++k )
+    {
+        r[k]     = _mm256_permute2f128_ps( s[k], s[k + 4], 0x20 );
+        r[k + 4] = _mm256_permute2f128_ps( s[k], s[k + 4], 0x31 );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: transformVerticesAVX()
+// Desc: Eight vertices at a time. A whole vertex fits in one AVX register,
+//       so one 8x8 transpose gives every field of all eight, and another
+//       turns the eight transformed fields back into eight vertices.
+//-----------------------------------------------------------------------------
+__attribute__((target("avx")))
+static void transformVerticesAVX( const float *m, const float *n,
+                                  const float *pIn, float *pOut, int nNumVertices )
+{
+    __m256 am[16], an[9];
+
+    for( int k = 0; k < 16; ++k )
+        am[k] = _mm256_set1_ps( m[k] );
+
+    for( int k = 0; k < 9; ++k )
+        an[k] = _mm256_set1_ps( n[k] );
+
+    int i = 0;
+
+    for( ; i + 8 <= nNumVertices; i += 8 )
+    {
+        __m256 r[8];
+
+        for( int k = 0; k < 8; ++k )
+            r[k] = _mm256_loadu_ps( pIn + (i + k) * SPHERE_VERTEX_FLOATS );
+
+        transpose8x8( r );
+
+        __m256 nx = r[2], ny = r[3], nz = r[4];
+        __m256 vx = r[5], vy = r[6], vz = r[7];
+
+        for( int k = 0; k < 4; ++k )
+        {
+            r[k] = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( am[k], vx ), _mm256_mul_ps( am[k + 4], vy ) ),
+                                  _mm256_add_ps( _mm256_mul_ps( am[k + 8], vz ), am[k + 12] ) );
+        }
+
+        for( int k = 0; k < 3; ++k )
+        {
+            r[k + 4] = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( an[k], nx ), _mm256_mul_ps( an[k + 3], ny ) ),
+                                      _mm256_mul_ps( an[k + 6], nz ) );
+        }
+
+        r[7] = _mm256_setzero_ps();
+
+        transpose8x8( r );
+
+        for( int k = 0; k < 8; ++k )
+            _mm256_storeu_ps( pOut + (i + k) * TRANSFORMED_VERTEX_FLOATS, r[k] );
+    }
+
+    transformVerticesScalar( m, n, pIn  + i * SPHERE_VERTEX_FLOATS,
+                                   pOut + i * TRANSFORMED_VERTEX_FLOATS, nNumVertices - i );
+}
+
+#endif /* VERTEX_TRANSFORM_X86 */
+
+//-----------------------------------------------------------------------------
+// Name: transformVertices()
+// Desc: Transforms nNumVertices vertices from pIn to pOut with a kernel.
+//-----------------------------------------------------------------------------
+void transformVertices( const float *pMatrix, const float *pNormalMatrix,
+                        const float *pIn, float *pOut, int nNumVertices,
+                        int nKernel )
+{
+#ifdef VERTEX_TRANSFORM_X86
+    if( nKernel == SPHERE_KERNEL_AVX )
+    {
+        transformVerticesAVX( pMatrix, pNormalMatrix, pIn, pOut, nNumVertices );
+        return;
+    }
+
+    if( nKernel == SPHERE_KERNEL_SSE )
+    {
+        transformVerticesSSE( pMatrix, pNormalMatrix, pIn, pOut, nNumVertices );
+        return;
+    }
+#endif
+
+    transformVerticesScalar( pMatrix, pNormalMatrix, pIn, pOut, nNumVertices );
+}
+
+//-----------------------------------------------------------------------------
+// Name: multiplyMatrices()
+// Desc: pOut = pA * pB, all column-major 4x4s. pOut mustn't be pA or pB.
+//-----------------------------------------------------------------------------
+void multiplyMatrices( const float *pA, const float *pB, float *pOut )
+{
+    for( int c = 0; c < 4; ++c )
+    {
+        for( int r = 0; r < 4; ++r )
+        {
+            pOut[c*4 + r] = pA[r]      * pB[c*4]     + pA[4 + r]  * pB[c*4 + 1] +
+                            pA[8 + r]  * pB[c*4 + 2] + pA[12 + r] * pB[c*4 + 3];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: getNormalMatrix()
+// Desc: The inverse transpose of the modelview's upper 3x3, as OpenGL
+//       transforms normals with. Its columns are the cross products of the
+//       other two columns of the 3x3, over the determinant.
+//-----------------------------------------------------------------------------
+void getNormalMatrix( const float *pModelView, float *pNormalMatrix )
+{
+    const float *a = pModelView;
+    const float *b = pModelView + 4;
+    const float *c = pModelView + 8;
+
+    float bc[3] = { b[1]*c[2] - b[2]*c[1], b[2]*c[0] - b[0]*c[2], b[0]*c[1] - b[1]*c[0] };
+    float ca[3] = { c[1]*a[2] - c[2]*a[1], c[2]*a[0] - c[0]*a[2], c[0]*a[1] - c[1]*a[0] };
+    float ab[3] = { a[1]*b[2] - a[2]*b[1], a[2]*b[0] - a[0]*b[2], a[0]*b[1] - a[1]*b[0] };
+
+    float fDet = a[0]*bc[0] + a[1]*bc[1] + a[2]*bc[2];
+    float fInv = (fabsf( fDet ) > 0.0f) ? 1.0f / fDet : 0.0f;
+
+    for( int k = 0; k < 3; ++k )
+    {
+        pNormalMatrix[k]     = bc[k] * fInv;
+        pNormalMatrix[3 + k] = ca[k] * fInv;
+        pNormalMatrix[6 + k] = ab[k] * fInv;
+    }
+}
@@ -0,0 +1,36 @@
+//-----------------------------------------------------------------------------
+//           Name: vertex_transform.h
+//    Description: Software transform of the sphere's GL_T2F_N3F_V3F
+//                 vertices, for comparing against the driver's own T&L.
+//                 Each vertex's position is multiplied by the
+//                 modelview-projection matrix into clip space, and its
+//                 normal by the normal matrix into eye space, giving
+//
+//                   x, y, z, w, nx, ny, nz, 0
+//
+//                 which is drawn with identity matrices, so the driver has
+//                 nothing left to transform. The SIMD kernels load a batch
+//                 of vertices, transpose it so each register holds one
+//                 field of every vertex, transform 4 (SSE) or 8 (AVX)
+//                 vertices per multiply-add, and transpose the results
+//                 back. They're picked with the same SPHERE_KERNEL_*
+//                 numbers as the generation kernels.
+//-----------------------------------------------------------------------------
+
+#ifndef _VERTEX_TRANSFORM_H_
+#define _VERTEX_TRANSFORM_H_
+
+// Floats per transformed vertex, laid out as x, y, z, w, nx, ny, nz, 0
+#define TRANSFORMED_VERTEX_FLOATS 8
+
+// pMatrix is a column-major 4x4, as glGetFloatv() returns them, and
+// pNormalMatrix a column-major 3x3. pIn holds SPHERE_VERTEX_FLOATS floats
+// per vertex and pOut TRANSFORMED_VERTEX_FLOATS.
+void transformVertices( const float *pMatrix, const float *pNormalMatrix,
+                        const float *pIn, float *pOut, int nNumVertices,
+                        int nKernel );
+
+void multiplyMatrices( const float *pA, const float *pB, float *pOut );
+void getNormalMatrix( const float *pModelView, float *pNormalMatrix );
+
+#endif /* _VERTEX_TRANSFORM_H_ */